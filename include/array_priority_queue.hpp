@@ -5,7 +5,10 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <utility>                  //std::move in try_dequeue
 #include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
+#include "gt_policy.hpp"
 
 
 namespace ics {
@@ -16,15 +19,19 @@ namespace ics {
 //If both tgt and cgt are supplied, then they must be the same (by ==) function.
 //If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
 //The (unique) non-nullptr value supplied by tgt/cgt is stored in the instance variable gt.
-template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPriorityQueue {
+//Alternatively, instantiate with tgt == nullptr and a Compare type (e.g., std::less<T>) whose
+//  operator()(a,b) means tgt(a,b): calls are then inlinable; see gt_policy.hpp.
+template<class T, bool (*tgt)(const T& a, const T& b) = nullptr, class Compare = void>
+class ArrayPriorityQueue : private GtPolicy<T,tgt,Compare> {
   public:
     //Destructor/Constructors
     ~ArrayPriorityQueue ();
 
     ArrayPriorityQueue          (bool (*cgt)(const T& a, const T& b) = nullptr);
     explicit ArrayPriorityQueue (int initial_length, bool (*cgt)(const T& a, const T& b) = nullptr);
-    ArrayPriorityQueue          (const ArrayPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = nullptr);
+    ArrayPriorityQueue          (const ArrayPriorityQueue<T,tgt,Compare>& to_copy, bool (*cgt)(const T& a, const T& b) = nullptr);
     explicit ArrayPriorityQueue (const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = nullptr);
+    explicit ArrayPriorityQueue (const typename GtPolicy<T,tgt,Compare>::Comparator& compare); //Compare != void only
 
     //Iterable class must support "for-each" loop: .begin()/.end()/.size() and prefix ++ on returned result
     template <class Iterable>
@@ -35,6 +42,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPrio
     bool empty      () const;
     int  size       () const;
     T&   peek       () const;
+    bool try_peek   (T*& top) const;  //if empty, false (top unchanged); else top = &peek(), true
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
 
@@ -42,6 +50,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPrio
 
     int  enqueue (const T& element);
     T    dequeue ();
+    bool try_dequeue (T& top);        //if empty, false (top unchanged); else top = dequeue(), true
     void clear   ();
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
@@ -50,44 +59,44 @@ template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPrio
 
 
     //Operators
-    ArrayPriorityQueue<T,tgt>& operator = (const ArrayPriorityQueue<T,tgt>& rhs);
-    bool operator == (const ArrayPriorityQueue<T,tgt>& rhs) const;
-    bool operator != (const ArrayPriorityQueue<T,tgt>& rhs) const;
+    ArrayPriorityQueue<T,tgt,Compare>& operator = (const ArrayPriorityQueue<T,tgt,Compare>& rhs);
+    bool operator == (const ArrayPriorityQueue<T,tgt,Compare>& rhs) const;
+    bool operator != (const ArrayPriorityQueue<T,tgt,Compare>& rhs) const;
 
-    template<class T2, bool (*gt2)(const T2& a, const T2& b)>
-    friend std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T2,gt2>& p);
+    template<class T2, bool (*gt2)(const T2& a, const T2& b), class Compare2>
+    friend std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T2,gt2,Compare2>& p);
 
 
 
     class Iterator {
       public:
-        //Private constructor called in begin/end, which are friends of ArrayPriorityQueue<T,tgt>
+        //Private constructor called in begin/end, which are friends of ArrayPriorityQueue<T,tgt,Compare>
         ~Iterator();
         T           erase();
         std::string str  () const;
-        ArrayPriorityQueue<T,tgt>::Iterator& operator ++ ();
-        ArrayPriorityQueue<T,tgt>::Iterator  operator ++ (int);
-        bool operator == (const ArrayPriorityQueue<T,tgt>::Iterator& rhs) const;
-        bool operator != (const ArrayPriorityQueue<T,tgt>::Iterator& rhs) const;
+        ArrayPriorityQueue<T,tgt,Compare>::Iterator& operator ++ ();
+        ArrayPriorityQueue<T,tgt,Compare>::Iterator  operator ++ (int);
+        bool operator == (const ArrayPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
+        bool operator != (const ArrayPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
         T& operator *  () const;
         T* operator -> () const;
-        friend std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt>::Iterator& i) {
+        friend std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt,Compare>::Iterator& i) {
           outs << i.str(); //Use the same meaning as the debugging .str() method
           return outs;
         }
 
-        friend Iterator ArrayPriorityQueue<T,tgt>::begin () const;
-        friend Iterator ArrayPriorityQueue<T,tgt>::end   () const;
+        friend Iterator ArrayPriorityQueue<T,tgt,Compare>::begin () const;
+        friend Iterator ArrayPriorityQueue<T,tgt,Compare>::end   () const;
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
         int                        current;
-        ArrayPriorityQueue<T,tgt>* ref_pq;
+        ArrayPriorityQueue<T,tgt,Compare>* ref_pq;
         int                        expected_mod_count;
         bool                       can_erase = true;
 
         //Called in friends begin/end
-        Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, int initial);
+        Iterator(ArrayPriorityQueue<T,tgt,Compare>* iterate_over, int initial);
     };
 
 
@@ -96,7 +105,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPrio
 
 
   private:
-    bool (*gt) (const T& a, const T& b); // The gt used by enqueue (from template or constructor)
+    typedef GtPolicy<T,tgt,Compare> Gt;  // Supplies this->gt (from template, constructor, or Compare)
     T*  pq;                              // Smaller values in lower indexes (biggest is at used-1)
     int length    = 0;                   //Physical length of array: must be >= .size()
     int used      = 0;                   //Amount of array used:  invariant: 0 <= used <= length
@@ -118,31 +127,25 @@ template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> class ArrayPrio
 
 //Destructor/Constructors
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::~ArrayPriorityQueue() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::~ArrayPriorityQueue() {
   delete[] pq;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt) {
-  if (gt == nullptr)
-    throw TemplateFunctionError("ArrayPriorityQueue::default constructor: neither specified");
-  if (tgt != nullptr && cgt != nullptr && tgt != cgt)
-    throw TemplateFunctionError("ArrayPriorityQueue::default constructor: both specified and different");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+  this->check_gt(cgt, "ArrayPriorityQueue::default constructor");
 
   pq = new T[length];
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(int initial_length, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt), length(initial_length) {
-  if (gt == nullptr)
-    throw TemplateFunctionError("ArrayPriorityQueue::length constructor: neither specified");
-  if (tgt != nullptr && cgt != nullptr && tgt != cgt)
-    throw TemplateFunctionError("ArrayPriorityQueue::length constructor: both specified and different");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(int initial_length, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt), length(initial_length) {
+  this->check_gt(cgt, "ArrayPriorityQueue::length constructor");
 
   if (length < 0)
     length = 0;
@@ -150,17 +153,14 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(int initial_length, bool (*cgt)(co
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const ArrayPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt), length(to_copy.length) {
-  if (gt == nullptr)
-    gt = to_copy.gt;//throw TemplateFunctionError("ArrayPriorityQueue::copy constructor: neither specified");
-  if (tgt != nullptr && cgt != nullptr && tgt != cgt)
-    throw TemplateFunctionError("ArrayPriorityQueue::copy constructor: both specified and different");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(const ArrayPriorityQueue<T,tgt,Compare>& to_copy, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt, to_copy), length(to_copy.length) {
+  this->check_gt(cgt, "ArrayPriorityQueue::copy constructor");
 
   pq = new T[length];
 
-  if (gt == to_copy.gt) {
+  if (cgt == nullptr || this->same_gt(to_copy)) {  //Gt copied to_copy's gt unless cgt was supplied
     used = to_copy.used;
     for (int i=0; i<to_copy.used; ++i)
       pq[i] = to_copy.pq[i];
@@ -170,13 +170,10 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const ArrayPriorityQueue<T,tgt>& t
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt), length(il.size()) {
-  if (gt == nullptr)
-    throw TemplateFunctionError("ArrayPriorityQueue::initializer_list constructor: neither specified");
-  if (tgt != nullptr && cgt != nullptr && tgt != cgt)
-    throw TemplateFunctionError("ArrayPriorityQueue::initializer_list constructor: both specified and different");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt), length(il.size()) {
+  this->check_gt(cgt, "ArrayPriorityQueue::initializer_list constructor");
 
   pq = new T[length];
   for (const T& pq_elem : il)
@@ -184,14 +181,18 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const std::initializer_list<T>& il
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare)
+: Gt(compare) {
+  pq = new T[length];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
 template<class Iterable>
-ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
-  : gt(tgt != nullptr ? tgt : cgt), length(i.size()) {
-  if (gt == nullptr)
-    throw TemplateFunctionError("ArrayPriorityQueue::Iterable constructor: neither specified");
-  if (tgt != nullptr && cgt != nullptr && tgt != cgt)
-    throw TemplateFunctionError("ArrayPriorityQueue::Iterable constructor: both specified and different");
+ArrayPriorityQueue<T,tgt,Compare>::ArrayPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
+  : Gt(cgt), length(i.size()) {
+  this->check_gt(cgt, "ArrayPriorityQueue::Iterable constructor");
 
   pq = new T[length];
   for (const T& v : i)
@@ -203,20 +204,20 @@ ArrayPriorityQueue<T,tgt>::ArrayPriorityQueue(const Iterable& i, bool (*cgt)(con
 //
 //Queries
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool ArrayPriorityQueue<T,tgt>::empty() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::empty() const {
   return used == 0;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-int ArrayPriorityQueue<T,tgt>::size() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int ArrayPriorityQueue<T,tgt,Compare>::size() const {
   return used;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T& ArrayPriorityQueue<T,tgt>::peek () const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& ArrayPriorityQueue<T,tgt,Compare>::peek () const {
   if (empty())
     throw EmptyError("ArrayPriorityQueue::peek");
 
@@ -224,8 +225,18 @@ T& ArrayPriorityQueue<T,tgt>::peek () const {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::string ArrayPriorityQueue<T,tgt>::str() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::try_peek (T*& top) const {
+  if (empty())
+    return false;
+
+  top = &pq[used-1];
+  return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string ArrayPriorityQueue<T,tgt,Compare>::str() const {
   std::ostringstream answer;
   answer << "ArrayPriorityQueue[";
 
@@ -244,12 +255,12 @@ std::string ArrayPriorityQueue<T,tgt>::str() const {
 //
 //Commands
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-int ArrayPriorityQueue<T,tgt>::enqueue(const T& element) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int ArrayPriorityQueue<T,tgt,Compare>::enqueue(const T& element) {
   this->ensure_length(used+1);
   pq[used++] = element;
   for (int i=used-2; i>=0; --i)
-    if (gt(pq[i],pq[i+1]))
+    if (this->gt(pq[i],pq[i+1]))
       std::swap(pq[i],pq[i+1]);
     else
       break;
@@ -258,8 +269,8 @@ int ArrayPriorityQueue<T,tgt>::enqueue(const T& element) {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T ArrayPriorityQueue<T,tgt>::dequeue() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T ArrayPriorityQueue<T,tgt,Compare>::dequeue() {
   if (this->empty())
     throw EmptyError("ArrayPriorityQueue::dequeue");
 
@@ -268,16 +279,27 @@ T ArrayPriorityQueue<T,tgt>::dequeue() {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void ArrayPriorityQueue<T,tgt>::clear() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::try_dequeue(T& top) {
+  if (this->empty())
+    return false;
+
+  ++mod_count;
+  top = std::move(pq[--used]);
+  return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void ArrayPriorityQueue<T,tgt,Compare>::clear() {
   used = 0;
   ++mod_count;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
 template <class Iterable>
-int ArrayPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+int ArrayPriorityQueue<T,tgt,Compare>::enqueue_all (const Iterable& i) {
   int count = 0;
   for (const T& v : i)
      count += enqueue(v);
@@ -290,12 +312,12 @@ int ArrayPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
 //
 //Operators
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>& ArrayPriorityQueue<T,tgt>::operator = (const ArrayPriorityQueue<T,tgt>& rhs) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>& ArrayPriorityQueue<T,tgt,Compare>::operator = (const ArrayPriorityQueue<T,tgt,Compare>& rhs) {
   if (this == &rhs)
     return *this;
 
-  gt = rhs.gt;   // if tgt != nullptr, gts are already equal (or compiler error)
+  this->assign_gt(rhs);   // if tgt != nullptr, gts are already equal (or compiler error)
   this->ensure_length(rhs.used);
   used = rhs.used;
   for (int i=0; i<used; ++i)
@@ -306,17 +328,17 @@ ArrayPriorityQueue<T,tgt>& ArrayPriorityQueue<T,tgt>::operator = (const ArrayPri
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-  bool ArrayPriorityQueue<T,tgt>::operator == (const ArrayPriorityQueue<T,tgt>& rhs) const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+  bool ArrayPriorityQueue<T,tgt,Compare>::operator == (const ArrayPriorityQueue<T,tgt,Compare>& rhs) const {
   if (this == &rhs)
     return true;
 
-  if (gt != rhs.gt) //For PriorityQueues to be equal, they need the same gt function, and values
+  if (!this->same_gt(rhs)) //For PriorityQueues to be equal, they need the same gt function, and values
     return false;
 
   if (used != rhs.size())
     return false;
-  ArrayPriorityQueue<T,tgt>::Iterator rhs_i = rhs.begin();
+  ArrayPriorityQueue<T,tgt,Compare>::Iterator rhs_i = rhs.begin();
   for (int i=used-1; i>=0; --i,++rhs_i)
     // Uses ! and ==, so != on T need not be defined
     if (!(pq[i] == *rhs_i))
@@ -326,14 +348,14 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool ArrayPriorityQueue<T,tgt>::operator != (const ArrayPriorityQueue& rhs) const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::operator != (const ArrayPriorityQueue& rhs) const {
   return !(*this == rhs);
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt>& p) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt,Compare>& p) {
   outs << "priority_queue[";
 
   if (!p.empty()) {
@@ -351,15 +373,15 @@ std::ostream& operator << (std::ostream& outs, const ArrayPriorityQueue<T,tgt>&
 //
 //Iterator constructors
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto ArrayPriorityQueue<T,tgt>::begin () const -> ArrayPriorityQueue<T,tgt>::Iterator {
-  return Iterator(const_cast<ArrayPriorityQueue<T,tgt>*>(this),used-1);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto ArrayPriorityQueue<T,tgt,Compare>::begin () const -> ArrayPriorityQueue<T,tgt,Compare>::Iterator {
+  return Iterator(const_cast<ArrayPriorityQueue<T,tgt,Compare>*>(this),used-1);
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto ArrayPriorityQueue<T,tgt>::end () const -> ArrayPriorityQueue<T,tgt>::Iterator {
-  return Iterator(const_cast<ArrayPriorityQueue<T,tgt>*>(this),-1);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto ArrayPriorityQueue<T,tgt,Compare>::end () const -> ArrayPriorityQueue<T,tgt,Compare>::Iterator {
+  return Iterator(const_cast<ArrayPriorityQueue<T,tgt,Compare>*>(this),-1);
 }
 
 
@@ -367,8 +389,8 @@ auto ArrayPriorityQueue<T,tgt>::end () const -> ArrayPriorityQueue<T,tgt>::Itera
 //
 //Private helper methods
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-int ArrayPriorityQueue<T,tgt>::erase_at(int i) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int ArrayPriorityQueue<T,tgt,Compare>::erase_at(int i) {
   for (int j=i; j<used-1; ++j)
     pq[j] = pq[j+1];
   --used;
@@ -377,8 +399,8 @@ int ArrayPriorityQueue<T,tgt>::erase_at(int i) {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void ArrayPriorityQueue<T,tgt>::ensure_length(int new_length) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void ArrayPriorityQueue<T,tgt,Compare>::ensure_length(int new_length) {
   if (length >= new_length)
     return;
   T* old_pq = pq;
@@ -398,19 +420,19 @@ void ArrayPriorityQueue<T,tgt>::ensure_length(int new_length) {
 //
 //Iterator class definitions
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::Iterator::Iterator(ArrayPriorityQueue<T,tgt>* iterate_over, int initial)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::Iterator::Iterator(ArrayPriorityQueue<T,tgt,Compare>* iterate_over, int initial)
 : current(initial), ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count) {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-ArrayPriorityQueue<T,tgt>::Iterator::~Iterator()
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+ArrayPriorityQueue<T,tgt,Compare>::Iterator::~Iterator()
 {}
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T ArrayPriorityQueue<T,tgt>::Iterator::erase() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T ArrayPriorityQueue<T,tgt,Compare>::Iterator::erase() {
   if (expected_mod_count != ref_pq->mod_count)
     throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::erase");
   if (!can_erase)
@@ -427,17 +449,17 @@ T ArrayPriorityQueue<T,tgt>::Iterator::erase() {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::string ArrayPriorityQueue<T,tgt>::Iterator::str() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string ArrayPriorityQueue<T,tgt,Compare>::Iterator::str() const {
   std::ostringstream answer;
   answer << ref_pq->str() << "/current=" << current << "/expected_mod_count=" << expected_mod_count << "/can_erase=" << can_erase;
   return answer.str();
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto ArrayPriorityQueue<T,tgt>::Iterator::operator ++ () -> ArrayPriorityQueue<T,tgt>::Iterator& {
-  if (expected_mod_count != ref_pq->mod_count)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator ++ () -> ArrayPriorityQueue<T,tgt,Compare>::Iterator& {
+  if (checked_iterators && expected_mod_count != ref_pq->mod_count)
     throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator ++");
 
   if (current < 0)
@@ -452,9 +474,9 @@ auto ArrayPriorityQueue<T,tgt>::Iterator::operator ++ () -> ArrayPriorityQueue<T
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto ArrayPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> ArrayPriorityQueue<T,tgt>::Iterator {
-  if (expected_mod_count != ref_pq->mod_count)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator ++ (int) -> ArrayPriorityQueue<T,tgt,Compare>::Iterator {
+  if (checked_iterators && expected_mod_count != ref_pq->mod_count)
     throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator ++(int)");
 
   if (current < 0)
@@ -470,39 +492,43 @@ auto ArrayPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> ArrayPriorityQueu
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool ArrayPriorityQueue<T,tgt>::Iterator::operator == (const ArrayPriorityQueue<T,tgt>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayPriorityQueue::Iterator::operator ==");
-  if (expected_mod_count != ref_pq->mod_count)
-    throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator ==");
-  if (ref_pq != rhsASI->ref_pq)
-    throw ComparingDifferentIteratorsError("ArrayPriorityQueue::Iterator::operator ==");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator == (const ArrayPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayPriorityQueue::Iterator::operator ==");
+    if (expected_mod_count != ref_pq->mod_count)
+      throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator ==");
+    if (ref_pq != rhsASI->ref_pq)
+      throw ComparingDifferentIteratorsError("ArrayPriorityQueue::Iterator::operator ==");
+  }
 
-  return current == rhsASI->current;
+  return current == rhs.current;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool ArrayPriorityQueue<T,tgt>::Iterator::operator != (const ArrayPriorityQueue<T,tgt>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayPriorityQueue::Iterator::operator !=");
-  if (expected_mod_count != ref_pq->mod_count)
-    throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator !=");
-  if (ref_pq != rhsASI->ref_pq)
-    throw ComparingDifferentIteratorsError("ArrayPriorityQueue::Iterator::operator !=");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator != (const ArrayPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayPriorityQueue::Iterator::operator !=");
+    if (expected_mod_count != ref_pq->mod_count)
+      throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator !=");
+    if (ref_pq != rhsASI->ref_pq)
+      throw ComparingDifferentIteratorsError("ArrayPriorityQueue::Iterator::operator !=");
+  }
 
-  return current != rhsASI->current;
+  return current != rhs.current;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T& ArrayPriorityQueue<T,tgt>::Iterator::operator *() const {
-  if (expected_mod_count != ref_pq->mod_count)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator *() const {
+  if (checked_iterators && expected_mod_count != ref_pq->mod_count)
     throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator *");
-  if (!can_erase || current < 0 || current >= ref_pq->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_pq->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_pq->size();
     throw IteratorPositionIllegal("ArrayPriorityQueue::Iterator::operator * Iterator illegal: "+where.str());
@@ -512,11 +538,11 @@ T& ArrayPriorityQueue<T,tgt>::Iterator::operator *() const {
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T* ArrayPriorityQueue<T,tgt>::Iterator::operator ->() const {
-  if (expected_mod_count !=  ref_pq->mod_count)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T* ArrayPriorityQueue<T,tgt,Compare>::Iterator::operator ->() const {
+  if (checked_iterators && expected_mod_count != ref_pq->mod_count)
     throw ConcurrentModificationError("ArrayPriorityQueue::Iterator::operator ->");
-  if (!can_erase || current < 0 || current >= ref_pq->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_pq->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_pq->size();
     throw IteratorPositionIllegal("ArrayPriorityQueue::Iterator::operator -> Iterator illegal: "+where.str());
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <initializer_list>
 #include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
 
 
 namespace ics {
@@ -416,14 +417,14 @@ std::string ArrayQueue<T>::Iterator::str() const {
 
 template<class T>
 auto ArrayQueue<T>::Iterator::operator ++ () -> ArrayQueue<T>::Iterator& {
-  if (expected_mod_count != ref_queue->mod_count)
+  if (checked_iterators && expected_mod_count != ref_queue->mod_count)
     throw ConcurrentModificationError("ArrayQueue::Iterator::operator ++");
 
   if (current == ref_queue->rear)
     return *this;
 
   if (can_erase)
-    current = (current+1)%ref_queue->length;
+    current = current+1 == ref_queue->length ? 0 : current+1;   //not %: a divide per step
   else
     can_erase = true;  //current already indexes "one beyond" deleted value
 
@@ -433,7 +434,7 @@ auto ArrayQueue<T>::Iterator::operator ++ () -> ArrayQueue<T>::Iterator& {
 
 template<class T>
 auto ArrayQueue<T>::Iterator::operator ++ (int) -> ArrayQueue<T>::Iterator {
-  if (expected_mod_count != ref_queue->mod_count)
+  if (checked_iterators && expected_mod_count != ref_queue->mod_count)
     throw ConcurrentModificationError("ArrayQueue::Iterator::operator ++(int)");
 
   if (current == ref_queue->rear)
@@ -441,7 +442,7 @@ auto ArrayQueue<T>::Iterator::operator ++ (int) -> ArrayQueue<T>::Iterator {
 
   Iterator to_return(*this);
   if (can_erase)
-    current = (current+1)%ref_queue->length;
+    current = current+1 == ref_queue->length ? 0 : current+1;   //not %: a divide per step
   else
     can_erase = true;  //current already indexes "one beyond" deleted value
 
@@ -451,37 +452,41 @@ auto ArrayQueue<T>::Iterator::operator ++ (int) -> ArrayQueue<T>::Iterator {
 
 template<class T>
 bool ArrayQueue<T>::Iterator::operator == (const ArrayQueue<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayQueue::Iterator::operator ==");
-  if (expected_mod_count != ref_queue->mod_count)
-    throw ConcurrentModificationError("ArrayQueue::Iterator::operator ==");
-  if (ref_queue != rhsASI->ref_queue)
-    throw ComparingDifferentIteratorsError("ArrayQueue::Iterator::operator ==");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayQueue::Iterator::operator ==");
+    if (expected_mod_count != ref_queue->mod_count)
+      throw ConcurrentModificationError("ArrayQueue::Iterator::operator ==");
+    if (ref_queue != rhsASI->ref_queue)
+      throw ComparingDifferentIteratorsError("ArrayQueue::Iterator::operator ==");
+  }
 
-  return current == rhsASI->current;
+  return current == rhs.current;
 }
 
 
 template<class T>
 bool ArrayQueue<T>::Iterator::operator != (const ArrayQueue<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayQueue::Iterator::operator !=");
-  if (expected_mod_count != ref_queue->mod_count)
-    throw ConcurrentModificationError("ArrayQueue::Iterator::operator !=");
-  if (ref_queue != rhsASI->ref_queue)
-    throw ComparingDifferentIteratorsError("ArrayQueue::Iterator::operator !=");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayQueue::Iterator::operator !=");
+    if (expected_mod_count != ref_queue->mod_count)
+      throw ConcurrentModificationError("ArrayQueue::Iterator::operator !=");
+    if (ref_queue != rhsASI->ref_queue)
+      throw ComparingDifferentIteratorsError("ArrayQueue::Iterator::operator !=");
+  }
 
-  return current != rhsASI->current;
+  return current != rhs.current;
 }
 
 
 template<class T>
 T& ArrayQueue<T>::Iterator::operator *() const {
-  if (expected_mod_count != ref_queue->mod_count)
+  if (checked_iterators && expected_mod_count != ref_queue->mod_count)
     throw ConcurrentModificationError("ArrayQueue::Iterator::operator *");
-  if (!can_erase || !ref_queue->is_in(current)) {
+  if (checked_iterators && (!can_erase || !ref_queue->is_in(current))) {
     std::ostringstream where;
     where << current
           << " when front = " << ref_queue->front << " and "
@@ -495,9 +500,9 @@ T& ArrayQueue<T>::Iterator::operator *() const {
 
 template<class T>
 T* ArrayQueue<T>::Iterator::operator ->() const {
-  if (expected_mod_count != ref_queue->mod_count)
+  if (checked_iterators && expected_mod_count != ref_queue->mod_count)
     throw ConcurrentModificationError("ArrayQueue::Iterator::operator ->");
-  if (!can_erase || !ref_queue->is_in(current)) {
+  if (checked_iterators && (!can_erase || !ref_queue->is_in(current))) {
     std::ostringstream where;
     where << current
           << " when front = " << ref_queue->front << " and "
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <initializer_list>
 #include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
 
 
 namespace ics {
@@ -481,7 +482,7 @@ std::string ArraySet<T>::Iterator::str() const {
 
 template<class T>
 auto ArraySet<T>::Iterator::operator ++ () -> ArraySet<T>::Iterator& {
-  if (expected_mod_count != ref_set->mod_count)
+  if (checked_iterators && expected_mod_count != ref_set->mod_count)
     throw ConcurrentModificationError("ArraySet::Iterator::operator ++");
 
   if (current >= ref_set->used)
@@ -498,7 +499,7 @@ auto ArraySet<T>::Iterator::operator ++ () -> ArraySet<T>::Iterator& {
 
 template<class T>
 auto ArraySet<T>::Iterator::operator ++ (int) -> ArraySet<T>::Iterator {
-  if (expected_mod_count != ref_set->mod_count)
+  if (checked_iterators && expected_mod_count != ref_set->mod_count)
     throw ConcurrentModificationError("ArraySet::Iterator::operator ++(int)");
 
   if (current >= ref_set->used)
@@ -516,37 +517,41 @@ auto ArraySet<T>::Iterator::operator ++ (int) -> ArraySet<T>::Iterator {
 
 template<class T>
 bool ArraySet<T>::Iterator::operator == (const ArraySet<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArraySet::Iterator::operator ==");
-  if (expected_mod_count != ref_set->mod_count)
-    throw ConcurrentModificationError("ArraySet::Iterator::operator ==");
-  if (ref_set != rhsASI->ref_set)
-    throw ComparingDifferentIteratorsError("ArraySet::Iterator::operator ==");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArraySet::Iterator::operator ==");
+    if (expected_mod_count != ref_set->mod_count)
+      throw ConcurrentModificationError("ArraySet::Iterator::operator ==");
+    if (ref_set != rhsASI->ref_set)
+      throw ComparingDifferentIteratorsError("ArraySet::Iterator::operator ==");
+  }
 
-  return current == rhsASI->current;
+  return current == rhs.current;
 }
 
 
 template<class T>
 bool ArraySet<T>::Iterator::operator != (const ArraySet<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArraySet::Iterator::operator !=");
-  if (expected_mod_count != ref_set->mod_count)
-    throw ConcurrentModificationError("ArraySet::Iterator::operator !=");
-  if (ref_set != rhsASI->ref_set)
-    throw ComparingDifferentIteratorsError("ArraySet::Iterator::operator !=");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArraySet::Iterator::operator !=");
+    if (expected_mod_count != ref_set->mod_count)
+      throw ConcurrentModificationError("ArraySet::Iterator::operator !=");
+    if (ref_set != rhsASI->ref_set)
+      throw ComparingDifferentIteratorsError("ArraySet::Iterator::operator !=");
+  }
 
-  return current != rhsASI->current;
+  return current != rhs.current;
 }
 
 
 template<class T>
 T& ArraySet<T>::Iterator::operator *() const {
-  if (expected_mod_count != ref_set->mod_count)
+  if (checked_iterators && expected_mod_count != ref_set->mod_count)
     throw ConcurrentModificationError("ArraySet::Iterator::operator *");
-  if (!can_erase || current < 0 || current >= ref_set->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_set->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_set->size();
     throw IteratorPositionIllegal("ArraySet::Iterator::operator * Iterator illegal: "+where.str());
@@ -558,9 +563,9 @@ T& ArraySet<T>::Iterator::operator *() const {
 
 template<class T>
 T* ArraySet<T>::Iterator::operator ->() const {
-  if (expected_mod_count != ref_set->mod_count)
+  if (checked_iterators && expected_mod_count != ref_set->mod_count)
     throw ConcurrentModificationError("ArraySet::Iterator::operator ->");
-  if (!can_erase || current < 0 || current >= ref_set->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_set->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_set->size();
     throw IteratorPositionIllegal("ArraySet::Iterator::operator -> Iterator illegal: "+where.str());
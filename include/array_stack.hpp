@@ -6,6 +6,7 @@
 #include <sstream>
 #include <initializer_list>
 #include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
 
 
 namespace ics {
@@ -387,7 +388,7 @@ std::string ArrayStack<T>::Iterator::str() const {
 
 template<class T>
  auto ArrayStack<T>::Iterator::operator ++ () -> ArrayStack<T>::Iterator& {
-  if (expected_mod_count != ref_stack->mod_count)
+  if (checked_iterators && expected_mod_count != ref_stack->mod_count)
     throw ConcurrentModificationError("ArrayStack::Iterator::operator ++");
 
   if (current < 0)
@@ -404,7 +405,7 @@ template<class T>
 
 template<class T>
 auto ArrayStack<T>::Iterator::operator ++ (int) -> ArrayStack<T>::Iterator {
-  if (expected_mod_count != ref_stack->mod_count)
+  if (checked_iterators && expected_mod_count != ref_stack->mod_count)
     throw ConcurrentModificationError("ArrayStack::Iterator::operator ++(int)");
 
   if (current < 0)
@@ -422,37 +423,41 @@ auto ArrayStack<T>::Iterator::operator ++ (int) -> ArrayStack<T>::Iterator {
 
 template<class T>
 bool ArrayStack<T>::Iterator::operator == (const ArrayStack<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayStack::Iterator::operator ==");
-  if (expected_mod_count != ref_stack->mod_count)
-    throw ConcurrentModificationError("ArrayStack::Iterator::operator ==");
-  if (ref_stack != rhsASI->ref_stack)
-    throw ComparingDifferentIteratorsError("ArrayStack::Iterator::operator ==");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayStack::Iterator::operator ==");
+    if (expected_mod_count != ref_stack->mod_count)
+      throw ConcurrentModificationError("ArrayStack::Iterator::operator ==");
+    if (ref_stack != rhsASI->ref_stack)
+      throw ComparingDifferentIteratorsError("ArrayStack::Iterator::operator ==");
+  }
 
-  return current == rhsASI->current;
+  return current == rhs.current;
 }
 
 
 template<class T>
 bool ArrayStack<T>::Iterator::operator != (const ArrayStack<T>::Iterator& rhs) const {
-  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-  if (rhsASI == 0)
-    throw IteratorTypeError("ArrayStack::Iterator::operator !=");
-  if (expected_mod_count != ref_stack->mod_count)
-    throw ConcurrentModificationError("ArrayStack::Iterator::operator !=");
-  if (ref_stack != rhsASI->ref_stack)
-    throw ComparingDifferentIteratorsError("ArrayStack::Iterator::operator !=");
+  if (checked_iterators) {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+      throw IteratorTypeError("ArrayStack::Iterator::operator !=");
+    if (expected_mod_count != ref_stack->mod_count)
+      throw ConcurrentModificationError("ArrayStack::Iterator::operator !=");
+    if (ref_stack != rhsASI->ref_stack)
+      throw ComparingDifferentIteratorsError("ArrayStack::Iterator::operator !=");
+  }
 
-  return current != rhsASI->current;
+  return current != rhs.current;
 }
 
 
 template<class T>
 T& ArrayStack<T>::Iterator::operator *() const {
-  if (expected_mod_count != ref_stack->mod_count)
+  if (checked_iterators && expected_mod_count != ref_stack->mod_count)
     throw ConcurrentModificationError("ArrayStack::Iterator::operator *");
-  if (!can_erase || current < 0 || current >= ref_stack->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_stack->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_stack->size();
     throw IteratorPositionIllegal("ArrayStack::Iterator::operator * Iterator illegal: "+where.str());
@@ -464,9 +469,9 @@ T& ArrayStack<T>::Iterator::operator *() const {
 
 template<class T>
 T* ArrayStack<T>::Iterator::operator ->() const {
-  if (expected_mod_count != ref_stack->mod_count)
+  if (checked_iterators && expected_mod_count != ref_stack->mod_count)
     throw ConcurrentModificationError("ArrayStack::Iterator::operator ->");
-  if (!can_erase || current < 0 || current >= ref_stack->used) {
+  if (checked_iterators && (!can_erase || current < 0 || current >= ref_stack->used)) {
     std::ostringstream where;
     where << current << " when size = " << ref_stack->size();
     throw IteratorPositionIllegal("ArrayStack::Iterator::operator -> Iterator illegal: "+where.str());
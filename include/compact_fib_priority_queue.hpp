@@ -0,0 +1,490 @@
+#ifndef COMPACT_FIB_PRIORITY_QUEUE_HPP_
+#define COMPACT_FIB_PRIORITY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>				//std::fill on the rank table
+#include <utility>
+#include <cstdint>
+#include "courselib/ics_exceptions.hpp"
+#include "gt_policy.hpp"
+namespace ics {
+
+
+//A Fibonacci heap priority queue whose nodes live in one contiguous vector and refer to each
+//  other by 32-bit indices; a node's degree and mark bit share one 32-bit word. For small T a
+//  node is about half the size of a FibPriorityQueue node, and consolidation walks one array.
+//gt is supplied as for FibPriorityQueue: tgt, cgt, or a Compare type (see gt_policy.hpp).
+//There is no Iterator (use for_each) and no merge. Handles stay valid until their element
+//  leaves the queue. T must be move-assignable: freed slots are reused by assignment.
+template<class T, bool (*tgt)(const T& a, const T& b) = nullptr, class Compare = void>
+class CompactFibPriorityQueue : private GtPolicy<T,tgt,Compare> {
+	public:
+		//Destructor/Constructors
+		CompactFibPriorityQueue(bool (*cgt)(const T& a, const T& b) = nullptr);
+		explicit CompactFibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare);	//Compare != void only
+		//Copy/move construction and assignment are the memberwise defaults
+
+
+		//Queries
+		bool empty		() const;
+		int	size		() const;
+		int	capacity	() const;		//Node slots allocated (live and free)
+		T&	peek		() const;
+		std::string str	() const; //supplies useful debugging information
+
+		//Calls f(const T&) once per element, in no particular order: O(capacity), no allocation
+		template <class Function>
+		void for_each	(Function f) const;
+
+
+		//Commands
+		class Handle;
+		int	enqueue	(const T& element);
+		int	enqueue	(T&& element);
+		int	enqueue	(const T& element, Handle& handle);	//handle refers to element until it leaves the queue
+		int	enqueue	(T&& element, Handle& handle);
+		T dequeue	();									//moves the value out of the queue
+		void clear	();
+		void reserve(int count);						//Room for count elements without reallocating
+
+		//handle must refer to an element still in this queue
+		int increase_priority	(const Handle& handle, const T& newValue);	//0 (no change) if newValue has lower priority
+
+
+		//Stable reference to one enqueued element (an index; see enqueue/increase_priority)
+		class Handle {
+			public:
+				Handle() : index(0xFFFFFFFF) {}
+				bool operator == (const Handle& rhs) const { return index == rhs.index; }
+				bool operator != (const Handle& rhs) const { return index != rhs.index; }
+
+			private:
+				friend class CompactFibPriorityQueue<T,tgt,Compare>;
+				std::uint32_t index;
+				Handle(std::uint32_t index) : index(index) {}
+		};
+
+	private:
+		typedef std::uint32_t Index;
+		static const Index NIL = 0xFFFFFFFF;				// No node (also: a free slot's parent)
+
+		//A root is its own parent (as in FibPriorityQueue); siblings form a circular list
+		struct Node {
+			template <class V>
+			Node(V&& value) : value(std::forward<V>(value)) {}
+
+			Index prev;
+			Index next;
+			Index parent;
+			Index child;
+			std::uint32_t rank;								// degree << 1 | marked
+			T value;
+
+			int	 degree	() const { return rank >> 1; }
+			bool marked	() const { return rank & 1; }
+		};
+
+		typedef GtPolicy<T,tgt,Compare> Gt;
+		std::vector<Node>	nodes;							// Live and free nodes, by index
+		Index	headRootNode	= NIL;						// The highest priority node
+		Index	freeList		= NIL;						// Free slots, linked through next
+		int		nodeCount		= 0;
+		int		modCount		= 0;
+		std::vector<Index>	rankTable;						// consolidateRank scratch (all NIL between calls)
+		long long rankTableLimit = 0;						// rankTable covers every degree while nodeCount < this
+
+
+		//Helper methods
+		template <class V>
+		Index	newNode			(V&& value);				//Reuses a free slot before growing nodes
+		inline void	addRootNode	(Index nextRootNode, Index toAdd);	//Adds toAdd before nextRootNode
+		inline void	removeRootNode	(Index toRemove);
+		inline void	replaceRootNode	(Index toReplace, Index replacement);
+		inline void	addChild	(Index parentNode, Index childNode);
+		void	consolidateRank	();
+		void	growRankTable	();
+		void	cutToRoot		(Index toCut);				//Cascading cut of a non-root node
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CompactFibPriorityQueue class and related definitions
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+const typename CompactFibPriorityQueue<T,tgt,Compare>::Index CompactFibPriorityQueue<T,tgt,Compare>::NIL;
+
+
+//Destructor/Constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+CompactFibPriorityQueue<T,tgt,Compare>::CompactFibPriorityQueue(bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "CompactFibPriorityQueue::default constructor");
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+CompactFibPriorityQueue<T,tgt,Compare>::CompactFibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare)
+: Gt(compare) {
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool CompactFibPriorityQueue<T,tgt,Compare>::empty() const {
+	return nodeCount == 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::size() const {
+	return nodeCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::capacity() const {
+	return nodes.capacity();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& CompactFibPriorityQueue<T,tgt,Compare>::peek () const {
+	if (this->empty())
+		throw EmptyError("CompactFibPriorityQueue::peek");
+
+	return const_cast<T&>(nodes[headRootNode].value);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string CompactFibPriorityQueue<T,tgt,Compare>::str() const {
+	std::ostringstream answer;
+	answer << "CompactFibPriorityQueue[";
+	if (headRootNode != NIL) {
+		//roots as value(degree), head first
+		Index cursor = headRootNode;
+		do {
+			answer << (cursor == headRootNode ? "" : ",") << nodes[cursor].value << "(" << nodes[cursor].degree() << ")";
+			cursor = nodes[cursor].next;
+		} while (cursor != headRootNode);
+	}
+	answer << "](nodeCount=" << nodeCount << ",slots=" << nodes.size() << ",modCount=" << modCount << ")";
+	return answer.str();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Function>
+void CompactFibPriorityQueue<T,tgt,Compare>::for_each(Function f) const {
+	for (const Node& node : nodes)
+		if (node.parent != NIL)
+			f(node.value);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::enqueue(const T& element) {
+	Handle handle;
+	return enqueue(element, handle);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::enqueue(T&& element) {
+	Handle handle;
+	return enqueue(std::move(element), handle);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::enqueue(const T& element, Handle& handle) {
+	handle.index = newNode(element);
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::enqueue(T&& element, Handle& handle) {
+	handle.index = newNode(std::move(element));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T CompactFibPriorityQueue<T,tgt,Compare>::dequeue() {
+	if (this->empty())
+		throw EmptyError("CompactFibPriorityQueue::dequeue");
+
+	Index oldHeadRootNode = headRootNode;
+	Node& head = nodes[oldHeadRootNode];
+	T headValue = std::move(head.value);
+
+	//splice the children (now roots) into the root list in front of the head
+	Index firstChild = head.child;
+	if (firstChild != NIL) {
+		Index child = firstChild;
+		do {
+			nodes[child].parent = child;
+			nodes[child].rank &= ~1u;
+			child = nodes[child].next;
+		} while (child != firstChild);
+
+		Index lastChild = nodes[firstChild].prev;
+		nodes[head.prev].next = firstChild;
+		nodes[firstChild].prev = head.prev;
+		nodes[lastChild].next = oldHeadRootNode;
+		head.prev = lastChild;
+	}
+
+	if (head.next == oldHeadRootNode) {
+		headRootNode = NIL;
+	} else {
+		headRootNode = head.next;
+		removeRootNode(oldHeadRootNode);
+	}
+
+	//free the slot
+	head.parent = NIL;
+	head.next = freeList;
+	freeList = oldHeadRootNode;
+	--nodeCount;
+	++modCount;
+
+	if (nodeCount == 0) {
+		nodes.clear();						//keeps the capacity
+		freeList = NIL;
+	} else
+		consolidateRank();
+	return headValue;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void CompactFibPriorityQueue<T,tgt,Compare>::clear() {
+	nodes.clear();
+	headRootNode = freeList = NIL;
+	nodeCount = 0;
+	++modCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void CompactFibPriorityQueue<T,tgt,Compare>::reserve(int count) {
+	nodes.reserve(count);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int CompactFibPriorityQueue<T,tgt,Compare>::increase_priority(const Handle& handle, const T& newValue) {
+	Index toIncrease = handle.index;
+	if (this->gt(nodes[toIncrease].value, newValue)) return 0;
+
+	nodes[toIncrease].value = newValue;
+
+	//heap property violated (not a root, and its parent no longer has strictly higher priority)
+	Index parent = nodes[toIncrease].parent;
+	if (parent != toIncrease && !this->gt(nodes[parent].value, nodes[toIncrease].value))
+		cutToRoot(toIncrease);
+
+	if (this->gt(nodes[toIncrease].value, nodes[headRootNode].value)) headRootNode = toIncrease;
+	++modCount;
+	return 1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class V>
+typename CompactFibPriorityQueue<T,tgt,Compare>::Index CompactFibPriorityQueue<T,tgt,Compare>::newNode(V&& value) {
+	Index index;
+	if (freeList != NIL) {
+		index = freeList;
+		freeList = nodes[index].next;
+		nodes[index].value = std::forward<V>(value);
+	} else {
+		index = nodes.size();
+		nodes.emplace_back(std::forward<V>(value));
+	}
+
+	Node& node = nodes[index];
+	node.prev = node.next = node.parent = index;
+	node.child = NIL;
+	node.rank = 0;
+
+	if (headRootNode == NIL) {
+		headRootNode = index;
+	} else {
+		addRootNode(headRootNode, index);
+		if (this->gt(node.value, nodes[headRootNode].value)) headRootNode = index;
+	}
+
+	++nodeCount;
+	++modCount;
+	return index;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void CompactFibPriorityQueue<T,tgt,Compare>::addRootNode(Index nextRootNode, Index toAdd) {
+	Index prevRootNode = nodes[nextRootNode].prev;
+	nodes[toAdd].next = nextRootNode;
+	nodes[toAdd].prev = prevRootNode;
+	nodes[prevRootNode].next = toAdd;
+	nodes[nextRootNode].prev = toAdd;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void CompactFibPriorityQueue<T,tgt,Compare>::removeRootNode(Index toRemove) {
+	nodes[nodes[toRemove].prev].next = nodes[toRemove].next;
+	nodes[nodes[toRemove].next].prev = nodes[toRemove].prev;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void CompactFibPriorityQueue<T,tgt,Compare>::replaceRootNode(Index toReplace, Index replacement) {
+	if (toReplace == replacement) return;
+	Index prevRootNode = nodes[toReplace].prev;
+	Index nextRootNode = nodes[toReplace].next;
+	if (prevRootNode == toReplace)
+		prevRootNode = nextRootNode = replacement;		//toReplace was the only root
+	nodes[replacement].prev = prevRootNode;
+	nodes[replacement].next = nextRootNode;
+	nodes[prevRootNode].next = replacement;
+	nodes[nextRootNode].prev = replacement;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void CompactFibPriorityQueue<T,tgt,Compare>::addChild(Index parentNode, Index childNode) {
+	Index firstChild = nodes[parentNode].child;
+	if (firstChild == NIL) {
+		nodes[childNode].prev = nodes[childNode].next = childNode;
+		nodes[parentNode].child = childNode;
+	} else
+		addRootNode(firstChild, childNode);				//same splice, within the child list
+	nodes[childNode].parent = parentNode;
+	nodes[parentNode].rank += 2;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void CompactFibPriorityQueue<T,tgt,Compare>::consolidateRank() {
+	if (headRootNode == NIL || nodes[headRootNode].next == headRootNode) return;
+
+	if (nodeCount >= rankTableLimit) growRankTable();
+
+	Index* rankArray = rankTable.data();
+	int maxRank = 0;
+	Index stopRootNode = headRootNode;
+	Index currentRootNode = headRootNode;
+
+	//iterate through all root nodes
+	do {
+		int currentRank = nodes[currentRootNode].degree();
+
+		//merge trees until the tree has a unique rank
+		while (rankArray[currentRank] != NIL) {
+			Index otherRootNode = rankArray[currentRank];
+
+			//move stopRootNode forward if it is going to leave the root list
+			if (otherRootNode == stopRootNode)
+				stopRootNode = nodes[stopRootNode].next;
+			removeRootNode(otherRootNode);
+
+			//the winner takes currentRootNode's place in the root list
+			bool otherWins = this->gt(nodes[otherRootNode].value, nodes[currentRootNode].value);
+			Index winnerRootNode = otherWins ? otherRootNode : currentRootNode;
+			Index loserRootNode = otherWins ? currentRootNode : otherRootNode;
+			replaceRootNode(currentRootNode, winnerRootNode);
+			stopRootNode = currentRootNode == stopRootNode ? winnerRootNode : stopRootNode;
+			currentRootNode = winnerRootNode;
+
+			addChild(currentRootNode, loserRootNode);
+			rankArray[currentRank++] = NIL;
+		}
+
+		//update headRootNode to point to max value
+		headRootNode = this->gt(nodes[headRootNode].value, nodes[currentRootNode].value) ? headRootNode : currentRootNode;
+
+		rankArray[currentRank] = currentRootNode;
+		if (currentRank > maxRank) maxRank = currentRank;
+		currentRootNode = nodes[currentRootNode].next;
+	} while (currentRootNode != stopRootNode);
+
+	//leave the table empty for the next call
+	std::fill(rankArray, rankArray + maxRank + 1, NIL);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void CompactFibPriorityQueue<T,tgt,Compare>::growRankTable() {
+	//as in FibPriorityQueue: degree d needs F(d+2) nodes, plus a few spare slots
+	int size = 2;
+	long long fibA = 2, fibB = 3;		//F(size+1), F(size+2)
+	while (fibB <= nodeCount) {
+		long long fibC = fibA + fibB;
+		fibA = fibB;
+		fibB = fibC;
+		++size;
+	}
+	for (int spare = 0; spare < 4; ++spare) {
+		long long fibC = fibA + fibB;
+		fibA = fibB;
+		fibB = fibC;
+		++size;
+	}
+	rankTable.assign(size, NIL);
+	rankTableLimit = fibB;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void CompactFibPriorityQueue<T,tgt,Compare>::cutToRoot(Index toCut) {
+	Index currentNode = toCut;
+	Index parentNode = toCut;
+
+	do {
+		parentNode = nodes[parentNode].parent;
+		//remove current node from parent's child list
+		if (nodes[currentNode].next == currentNode)
+			nodes[parentNode].child = NIL;
+		else {
+			removeRootNode(currentNode);				//same unlink, within the child list
+			if (nodes[parentNode].child == currentNode) nodes[parentNode].child = nodes[currentNode].next;
+		}
+		nodes[parentNode].rank -= 2;
+
+		//add current node to root list, unmarked
+		nodes[currentNode].parent = currentNode;
+		nodes[currentNode].rank &= ~1u;
+		addRootNode(headRootNode, currentNode);
+
+		currentNode = parentNode;
+	} while (nodes[currentNode].marked());
+
+	//mark parent if it's not a root node
+	if (nodes[parentNode].parent != parentNode) nodes[parentNode].rank |= 1;
+}
+
+}
+
+#endif /* COMPACT_FIB_PRIORITY_QUEUE_HPP_ */
@@ -7,6 +7,7 @@
 #include "courselib/ics46goody.hpp"
 #include "courselib/ics_exceptions.hpp"
 #include "fib_priority_queue.hpp"
+#include "strict_fib_priority_queue.hpp"
 
 
 namespace ics {
@@ -15,6 +16,7 @@ bool regular_gt(const std::string& a, const std::string& b) {return a < b;}
 bool reverse_gt(const std::string& a, const std::string& b) {return a > b;}
 
 typedef ics::FibPriorityQueue<std::string> PriorityQueueType;
+//typedef ics::StrictFibPriorityQueue<std::string> PriorityQueueType;   //worst-case bounds
 
 class DriverPriorityQueue {
   public:
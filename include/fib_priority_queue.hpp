@@ -1,17 +1,26 @@
 #ifndef FIB_PRIORITY_QUEUE_HPP_
 #define FIB_PRIORITY_QUEUE_HPP_
 
-#include <cmath>
-
 #include <string>
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
 #include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
 #include <utility>					//For std::swap function
+#include <vector>					//Iterator frontier
+#include <algorithm>				//std::push_heap/pop_heap on the frontier
+#include <new>						//For placement new into pool storage
+#include <type_traits>
+#include <cstdint>					//std::uintptr_t: see selectNode
+#include <thread>					//Parallel copy/teardown, background release
+#include <memory>					//std::unique_ptr: per-thread NodePools
+#include <exception>				//std::exception_ptr: errors in copying threads
 #include "array_stack.hpp"			//See operator <<
-#include "array_set.hpp"
 #include "array_queue.hpp"
+#include "node_pool.hpp"
+#include "gt_policy.hpp"
+#include "queue_stats.hpp"
 namespace ics {
 
 
@@ -20,15 +29,21 @@ namespace ics {
 //If both tgt and cgt are supplied, then they must be the same (by ==) function.
 //If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
 //The (unique) non-nullptr value supplied by tgt/cgt is stored in the instance variable gt.
-template<class T, bool (*tgt)(const T& a, const T& b) = nullptr> 
-class FibPriorityQueue {
+//Alternatively, instantiate with tgt == nullptr and a Compare type (e.g., std::less<T>) whose
+//  operator()(a,b) means tgt(a,b): calls are then inlinable; see gt_policy.hpp.
+template<class T, bool (*tgt)(const T& a, const T& b) = nullptr, class Compare = void>
+class FibPriorityQueue : private GtPolicy<T,tgt,Compare>, private FibQueueStatsStorage<> {
 	public:
 		//Destructor/Constructors
 		~FibPriorityQueue();
 
 		FibPriorityQueue(bool (*cgt)(const T& a, const T& b) = nullptr);
-		FibPriorityQueue(const FibPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = nullptr);
+		class Pool;
+		explicit FibPriorityQueue(Pool& sharedPool, bool (*cgt)(const T& a, const T& b) = nullptr);
+		FibPriorityQueue(const FibPriorityQueue<T,tgt,Compare>& to_copy, bool (*cgt)(const T& a, const T& b) = nullptr);
+		FibPriorityQueue(FibPriorityQueue<T,tgt,Compare>&& to_move);	//to_move is left empty
 		explicit FibPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = nullptr);
+		explicit FibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare);	//Compare != void only
 
 		//Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
 		template <class Iterable>
@@ -39,58 +54,146 @@ class FibPriorityQueue {
 		bool empty		() const;
 		int	size		() const;
 		T&	peek		() const;
+		bool try_peek	(T*& top) const;	//if empty, false (top unchanged); else top = &peek(), true
 		std::string str	() const; //supplies useful debugging information; contrast to operator <<
 
+		//Calls f(const T&) once per element, in no particular order: O(n), no allocation.
+		//f must not modify the queue
+		template <class Function>
+		void for_each	(Function f) const;
+
+		//Writes copies of the (up to) k highest priority values to out, highest first; returns
+		//  how many were written. Best-first search of the heap-ordered trees: a heap built from
+		//  the r roots (r = O(log n) after any dequeue), then k pops and <= k*O(log n) pushes.
+		//  The queue is not modified (iterators stay valid)
+		template <class OutputIterator>
+		int peek_k		(int k, OutputIterator out) const;
+
+		//Operation counts since construction or reset_stats; all 0 unless compiled with
+		//  -DICS_QUEUE_STATS (see queue_stats.hpp). stats().str() is a one-line dump
+		const FibQueueStats& stats() const;
+		void reset_stats	();
+
 
 		//Commands
+		class Handle;
 		int	enqueue	(const T& element);
-		T dequeue	();
+		int	enqueue	(T&& element);
+		int	enqueue	(const T& element, Handle& handle);	//handle refers to element until it leaves the queue
+		int	enqueue	(T&& element, Handle& handle);
+		template <class... Args>
+		int emplace	(Args&&... args);					//constructs the element in place from args
+		T dequeue	();									//moves the value out of the queue
+		bool try_dequeue(T& top);						//if empty, false (top unchanged); else moves it to top, true
 		void clear	();
 
+		//Batched dequeue: moves values to out, highest priority first, and returns how many.
+		//dequeue_n stops after n values (or when empty); drain_while stops at the first value
+		//  for which pred(const T&) is false (that value stays). Neither throws EmptyError.
+		//Checks and modCount are handled once per call; values are moved straight to out
+		template <class OutputIterator>
+		int dequeue_n	(int n, OutputIterator out);
+		template <class Predicate, class OutputIterator>
+		int drain_while	(Predicate pred, OutputIterator out);
+
+		//handle must refer to an element still in this queue
+		int increase_priority	(const Handle& handle, const T& newValue);	//0 (no change) if newValue has lower priority
+		int increase_priority	(const Handle& handle, T&& newValue);
+		T	erase				(const Handle& handle);
+
+		//Move every element of q2 into this queue, leaving q2 empty; q2 must use the same gt.
+		//O(1) (q2's owned Pool is adopted by this queue's, and handles into q2 then refer into this
+		//  queue) unless q2 uses a different shared Pool: then its elements are moved one by one, in
+		//  O(size of q2), and every handle into q2 is invalidated (it must not be used again)
+		int merge	(FibPriorityQueue<T,tgt,Compare>& q2);
+		int meld	(FibPriorityQueue<T,tgt,Compare>&& q2);
+
 		//Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
 		template <class Iterable>
 		int enqueue_all (const Iterable& i);
 
+		//Opt-in parallel copy/teardown: copying into this queue (copy constructor, operator =) and
+		//  destroying its nodes (clear, destructor, operator =) split the root list's trees over up
+		//  to threads threads (1, the default, is sequential; 0 means hardware_concurrency). Each
+		//  thread handles at least PARALLEL_GRAIN nodes, so small heaps stay sequential; parallel
+		//  teardown needs an owned pool. T's copy constructor and destructor must be safe to run
+		//  concurrently on distinct objects. A copy constructed queue inherits both settings
+		void set_parallelism		(int threads);
+		//Opt-in: clear (and the destructor) hand the nodes and an owned pool to a detached thread
+		//  that destroys them, and return at once (with a shared pool they are destroyed in place).
+		//  T's destructor must not depend on anything that may be gone by the time it runs
+		void set_background_release	(bool background);
+
+		static const int PARALLEL_GRAIN = 1 << 14;
+
+		//Opt-in incremental consolidation: with steps > 0, dequeue no longer consolidates the whole
+		//  root list. Instead roots wait on a pending list and each enqueue, dequeue and
+		//  increase_priority does max(steps, 2 * roots it added) steps, each one link of two trees of
+		//  equal degree or one tree placed in the (persistent) degree table. peek stays O(1); dequeue
+		//  scans only the pending roots, the O(log n) placed ones and the tree being linked, so a
+		//  burst of n enqueues no longer makes one dequeue O(n). steps == 0 (the default) restores
+		//  full consolidation. Roots added by merge or Iterator::erase are absorbed by later calls
+		void set_consolidation_budget(int steps);
+
 
 		//Operators
-		FibPriorityQueue<T,tgt>& operator = (const FibPriorityQueue<T,tgt>& rhs);
-		bool operator == (const FibPriorityQueue<T,tgt>& rhs) const;
-		bool operator != (const FibPriorityQueue<T,tgt>& rhs) const;
+		FibPriorityQueue<T,tgt,Compare>& operator = (const FibPriorityQueue<T,tgt,Compare>& rhs);
+		FibPriorityQueue<T,tgt,Compare>& operator = (FibPriorityQueue<T,tgt,Compare>&& rhs);
+		bool operator == (const FibPriorityQueue<T,tgt,Compare>& rhs) const;
+		bool operator != (const FibPriorityQueue<T,tgt,Compare>& rhs) const;
 
-		template<class T2, bool (*gt2)(const T2& a, const T2& b)>
-		friend std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T2,gt2>& pq);
-		
+		template<class T2, bool (*gt2)(const T2& a, const T2& b), class Compare2>
+		friend std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T2,gt2,Compare2>& pq);
+
+	private:
+		class HN;	//Defined below; Iterator walks the heap nodes in place
+
+	public:
 		class Iterator {
 			public:
-				//Private constructor called in begin/end, which are friends of FibPriorityQueue<T,tgt>
+				//Private constructor called in begin/end, which are friends of FibPriorityQueue<T,tgt,Compare>
 				~Iterator();
 				T			erase();
 				std::string str	() const;
-				FibPriorityQueue<T,tgt>::Iterator& operator ++ ();
-				FibPriorityQueue<T,tgt>::Iterator	operator ++ (int);
-				bool operator == (const FibPriorityQueue<T,tgt>::Iterator& rhs) const;
-				bool operator != (const FibPriorityQueue<T,tgt>::Iterator& rhs) const;
+				FibPriorityQueue<T,tgt,Compare>::Iterator& operator ++ ();
+				FibPriorityQueue<T,tgt,Compare>::Iterator	operator ++ (int);
+				bool operator == (const FibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
+				bool operator != (const FibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
 				T& operator *	() const;
 				T* operator -> () const;
-				friend std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T,tgt>::Iterator& i) {
+				friend std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T,tgt,Compare>::Iterator& i) {
 					outs << i.str(); //Use the same meaning as the debugging .str() method
 					return outs;
 				}
 
-				friend Iterator FibPriorityQueue<T,tgt>::begin () const;
-				friend Iterator FibPriorityQueue<T,tgt>::end   () const;
+				friend Iterator FibPriorityQueue<T,tgt,Compare>::begin () const;
+				friend Iterator FibPriorityQueue<T,tgt,Compare>::end   () const;
 
 			private:
-				//If can_erase is false, the value has been removed from "it" (++ does nothing)
-				FibPriorityQueue<T,tgt>		it; //copy of HPQ (from begin), to use as iterator via dequeue
-				FibPriorityQueue<T,tgt>* 	refPQ;
+				//Orders the frontier as a binary heap with the highest priority node at front()
+				class FrontierOrder {
+					public:
+						FrontierOrder(FibPriorityQueue<T,tgt,Compare>* pq) : pq(pq) {}
+						bool operator () (HN* a, HN* b) const { return pq->gt(b->getValue(), a->getValue()); }
+					private:
+						FibPriorityQueue<T,tgt,Compare>* pq;
+				};
+
+				//The frontier holds the roots and the children of every node already iterated past;
+				//  its front() is the current node. If canErase is false, the current node has been
+				//  erased and front() already is the "next" node (++ does nothing)
+				std::vector<HN*>			frontier;
+				FibPriorityQueue<T,tgt,Compare>* 	refPQ;
+				int							remaining;	//Nodes not yet iterated past (0 at end)
+				int							passed = 0;	//Nodes iterated past and still in refPQ
 				int							expectedModCount;
 				bool						canErase = true;
 
 				//Called in friends begin/end
-				//These constructors have different initializers (see it(...) in first one)
-				Iterator(FibPriorityQueue<T,tgt>* iterateOver, bool fromBegin);		// Called by begin
-				Iterator(FibPriorityQueue<T,tgt>* iterateOver);						// Called by end
+				Iterator(FibPriorityQueue<T,tgt,Compare>* iterateOver, int remaining);		// nodeCount: begin; 0: end
+
+				void advance();		//Replaces front() by its children
+				void restart();		//Frontier becomes refPQ's root list
 		};
 
 
@@ -98,61 +201,139 @@ class FibPriorityQueue {
 		Iterator end	() const;
 		
 	private:
+		//A heap node; siblings (and roots) are linked through prevNode/nextNode in a circular list.
+		//childNode is any one of the children (nullptr for a leaf); degree counts them
 		class HN {
 		public:
-			HN(const HN& toCopy)	: marked(toCopy.marked), value(toCopy.value) { childNodes = toCopy.childNodes; }
-			HN(const T& value)		: marked(false), value(value) { parentNode = this; }
+			template <class... Args>
+			HN(Args&&... args)		: value(std::forward<Args>(args)...), childNode(nullptr), degree(0), marked(false) { parentNode = this; prevNode = this; nextNode = this; }
 			
-			inline int addChild(HN* newChildNode) { return childNodes.insert(newChildNode); }
-			inline ArraySet<HN*>& getChildNodes() { return childNodes; }
+			inline void addChild(HN* newChildNode) {
+				if(childNode == nullptr) {
+					newChildNode->prevNode = newChildNode->nextNode = newChildNode;
+					childNode = newChildNode;
+				} else {
+					newChildNode->nextNode = childNode;
+					newChildNode->prevNode = childNode->prevNode;
+					childNode->prevNode->nextNode = newChildNode;
+					childNode->prevNode = newChildNode;
+				}
+				++degree;
+			}
+			inline void removeChild(HN* oldChildNode) {
+				if(oldChildNode->nextNode == oldChildNode) {
+					childNode = nullptr;
+				} else {
+					oldChildNode->prevNode->nextNode = oldChildNode->nextNode;
+					oldChildNode->nextNode->prevNode = oldChildNode->prevNode;
+					if(childNode == oldChildNode) childNode = oldChildNode->nextNode;
+				}
+				--degree;
+			}
+			inline HN*	getChild() { return childNode; }
+			inline int	getDegree() { return degree; }
 			inline T&	getValue() { return value; }
-			inline void setValue(const T& newValue) { value = newValue; }
+			template <class V>
+			inline void setValue(V&& newValue) { value = std::forward<V>(newValue); }
 			inline bool isMarked() { return marked; }
 			inline void setMarked() { marked = true; }	
 			inline void setUnmarked() { marked = false; }	
 			inline HN*	getParent() { return parentNode; }
 			inline int	setParent(HN* parent) { parentNode = parent; return 1;}
+
+			HN* prevNode;
+			HN* nextNode;
 		
 		private:	
+			T value;			//Next to the sibling links: root scans touch only these three
 			HN* parentNode;
-			ArraySet<HN*> childNodes;
+			HN* childNode;
+			int degree;
 	    	bool marked;
-			T value;			
+		};
+		
+	public:
+		//Storage for the nodes of one or more queues; see the sharedPool constructor
+		class Pool {
+			private:
+				friend class FibPriorityQueue<T,tgt,Compare>;
+				NodePool<HN>	heapNodes;
 		};
 
-		class DLN {
-	    public:
-			DLN(const DLN& toCopy) 	: heapNode(toCopy.heapNode), prevNode(toCopy.prevNode), nextNode(toCopy.nextNode) {}
-			DLN(HN* heapNode)		: heapNode(heapNode) { prevNode = this; nextNode = this; }	
-
+		//Stable reference to one enqueued element (see enqueue/increase_priority/erase)
+		class Handle {
+			public:
+				Handle() : heapNode(nullptr) {}
+				T& operator *	() const { return heapNode->getValue(); }
+				T* operator ->	() const { return &heapNode->getValue(); }
+				bool operator == (const Handle& rhs) const { return heapNode == rhs.heapNode; }
+				bool operator != (const Handle& rhs) const { return heapNode != rhs.heapNode; }
 
-			inline int addChild(HN* newChildNode) { return heapNode->getChildNodes().insert(newChildNode); }
-			inline ArraySet<HN*>& getChildNodes() { return heapNode->getChildNodes(); }
-			inline T& getValue() { return heapNode->getValue(); }
-		
-			HN* heapNode;
-	   		DLN* prevNode;
-			DLN* nextNode;
+			private:
+				friend class FibPriorityQueue<T,tgt,Compare>;
+				HN* heapNode;
+				Handle(HN* heapNode) : heapNode(heapNode) {}
 		};
-		
-		bool (*gt) (const T& a, const T& b);				// The gt used by enqueue (from template or constructor)
+
+	private:
+		typedef GtPolicy<T,tgt,Compare> Gt;					// Supplies this->gt (from template, constructor, or Compare)
 		int nodeCount		= 0;							// The number of nodes in the heap
 		int modCount		= 0;							// For sensing concurrent modification
-		DLN* headRootNode	= nullptr;						// A pointer to the head value 
+		HN* headRootNode	= nullptr;						// A pointer to the head value 
+		Pool* pool			= nullptr;						// Node storage (allocated on first use when owned)
+		bool ownsPool		= true;							// An owned pool is released wholesale by clear/destructor
+		std::vector<HN*> rankTable;							// consolidateRank scratch (all nullptr between calls
+															//   unless incremental: then the placed roots)
+		long long rankTableLimit = 0;						// rankTable covers every degree while nodeCount < this
+		int threadCount		= 1;							// See set_parallelism
+		bool backgroundRelease = false;						// See set_background_release
+		int consolidationBudget = 0;						// See set_consolidation_budget; when > 0:
+		HN* pendingRootNode	= nullptr;						//   first and last of the contiguous run of roots
+		HN* lastPendingRootNode = nullptr;					//   not yet placed in rankTable (nullptr: none)
+		HN* carryRootNode	= nullptr;						//   root being linked up to a free degree
+		int addedRootCount	= 0;							//   roots added since the last steps were done
 
 		
 		//Helper methods
-		inline void addRootNode(DLN* nextRootNode, DLN* toAdd);			//Adds a root node to the root list
-		inline void addRootNode(DLN* nextRootNode, DLN* toAdd) const;	//Adds a root node to the root list
-		inline void removeRootNode(DLN* toRemove);						//removes a root node from the root list
+		inline bool gt(const T& a, const T& b) const;					//Gt::gt, counted in statistics
+		static inline void addRootNode(HN* nextRootNode, HN* toAdd);			//Adds a root node to the root list
+		static inline void removeRootNode(HN* toRemove);				//removes a root node from the root list
+		inline void replaceRootNode(HN* toReplace, HN* replacement);	//replacement takes toReplace's place (may be equal)
+		inline void removeHeadRootNode();								//Promotes its children, deletes it; no consolidation
+
+		//a if first, else b: branch-free for arithmetic T, whose compares are cheap but unpredictable
+		static inline HN* selectNode(bool first, HN* a, HN* b);
+		static inline HN* selectNode(bool first, HN* a, HN* b, std::true_type arithmetic);
+		static inline HN* selectNode(bool first, HN* a, HN* b, std::false_type arithmetic);
+		template <class... Args>
+		inline HN*	newHeapNode(Args&&... args);						//Node allocation goes through the pool
+		inline void deleteHeapNode(HN* toDelete);
 		void consolidateRank();											//Ensures no two root nodes have the same rank
-		DLN*	copyFibTree(DLN* originalTree) const;
-		HN*		copyFibBranch(HN* originalBranch, HN* branchParent) const;
-		void	destroyFibTree(DLN* originalTree);
-		void	destroyFibBranch(HN* originalBranch);
-		HN*		findInFibTree(DLN* originalTree, const T& value) const;
-		HN*		findInFibBranch(HN* originalBranch, const T& value) const;
-		void	increaseKey(HN* toIncrease, const T& newValue);
+		void consolidateSteps();										//Incremental: see set_consolidation_budget
+		void findHeadRootNode();										//headRootNode = best root (scans the root list)
+		inline void addNewRootNode(HN* toAdd);							//Adds to the root list (pending if incremental)
+		inline void forgetRootNode(HN* toForget);						//Incremental: toForget is leaving the root list
+		void resetIncremental(bool allPending);							//Empties rankTable; every root pending or none
+		void growRankTable();											//Sizes rankTable for nodeCount
+		HN*		copyFibTree(HN* originalTree, int originalCount);		//Copies every tree in originalTree's root list
+		void	destroyFibTree(HN* originalTree, int originalCount);	//Destroys every tree in originalTree's root list
+		void	releaseFibTree();										//Destroys all nodes (see set_background_release)
+		int		parallelParts(HN* rootList, int count) const;			//Threads worth using on rootList's trees
+		static std::vector<HN*> splitRootList(HN* rootList, int parts);	//Run starts, balanced by degree
+		static HN*	copyRootRun(HN* first, HN* stop, NodePool<HN>& nodes);	//Copies first up to stop
+		static void	destroyRootList(HN* rootList, NodePool<HN>* recycle);	//recycle: nullptr to skip
+		HN*		enqueueNode(HN* tempRootNode);							//Adds a new node to the root list
+		template <class V>
+		void	increaseKey(HN* toIncrease, V&& newValue);
+		void	cutToRoot(HN* toCut);									//Cascading cut of a non-root node
+		void	promoteChildren(HN* parentHeapNode);					//Moves all children to the root list
+		T		eraseNode(HN* toErase);
+		T		extractNode(HN* toExtract);								//Like eraseNode, but no consolidation
+		template <class Predicate, class OutputIterator>
+		int		dequeueWhile(int limit, Predicate pred, OutputIterator out);	//See dequeue_n/drain_while
+
+		template <class Function>
+		void	forEachNode(Function f) const;							//Visits every node (f may move its value out)
 
 		void 	printFibBranch(std::ostream& outs, std::string& prefix, HN* currentHeapNode) const;
 };
@@ -167,40 +348,62 @@ class FibPriorityQueue {
 
 //Destructor/Constructors
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::~FibPriorityQueue() {
-	destroyFibTree(headRootNode);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::~FibPriorityQueue() {
+	releaseFibTree();
+	if(ownsPool) delete pool;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::FibPriorityQueue(bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt) {
-	if(gt == nullptr)
-		throw TemplateFunctionError("FibPriorityQueue::default constructor: neither specified");
-	if(tgt != nullptr && cgt != nullptr && tgt != cgt)
-		throw TemplateFunctionError("FibPriorityQueue::default constructor: both specified and different");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "FibPriorityQueue::default constructor");
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::FibPriorityQueue(const FibPriorityQueue<T,tgt>& toCopy, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt), nodeCount(toCopy.nodeCount) {
-	if(gt == nullptr)
-		gt = toCopy.gt;//throw TemplateFunctionError("FibPriorityQueue::copy constructor: neither specified");
-	if(tgt != nullptr && cgt != nullptr && tgt != cgt)
-		throw TemplateFunctionError("FibPriorityQueue::copy constructor: both specified and different");
 
-	headRootNode = copyFibTree(toCopy.headRootNode);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(Pool& sharedPool, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt), pool(&sharedPool), ownsPool(false) {
+	this->check_gt(cgt, "FibPriorityQueue::sharedPool constructor");
 }
 
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(const FibPriorityQueue<T,tgt,Compare>& toCopy, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt, toCopy), nodeCount(toCopy.nodeCount), threadCount(toCopy.threadCount), backgroundRelease(toCopy.backgroundRelease),
+  consolidationBudget(toCopy.consolidationBudget) {
+	this->check_gt(cgt, "FibPriorityQueue::copy constructor");
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::FibPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt) {
-	if(gt == nullptr)
-		throw TemplateFunctionError("FibPriorityQueue::initializer_list constructor: neither specified");
-	if(tgt != nullptr && cgt != nullptr && tgt != cgt)
-		throw TemplateFunctionError("FibPriorityQueue::initializer_list constructor: both specified and different");
+	//the tree shapes are only heap-ordered for toCopy's gt, which Gt copied unless cgt was supplied
+	if(cgt == nullptr || this->same_gt(toCopy)) {
+		headRootNode = copyFibTree(toCopy.headRootNode, toCopy.nodeCount);
+	} else {
+		nodeCount = 0;
+		toCopy.for_each([this] (const T& element) { enqueue(element); });
+		modCount = 0;
+	}
+	resetIncremental(true);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(FibPriorityQueue<T,tgt,Compare>&& toMove)
+: Gt(toMove), nodeCount(toMove.nodeCount), headRootNode(toMove.headRootNode), pool(toMove.pool), ownsPool(toMove.ownsPool),
+  threadCount(toMove.threadCount), backgroundRelease(toMove.backgroundRelease), consolidationBudget(toMove.consolidationBudget) {
+	//toMove keeps a shared pool; an owned one is recreated on its next enqueue
+	if(toMove.ownsPool) toMove.pool = nullptr;
+	resetIncremental(true);
+	toMove.resetIncremental(false);
+	toMove.headRootNode = nullptr;
+	toMove.nodeCount = 0;
+	++toMove.modCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "FibPriorityQueue::initializer_list constructor");
 
 	for(const T& element : il) enqueue(element);
 	consolidateRank();
@@ -208,14 +411,17 @@ FibPriorityQueue<T,tgt>::FibPriorityQueue(const std::initializer_list<T>& il, bo
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare)
+: Gt(compare) {
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
 template<class Iterable>
-FibPriorityQueue<T,tgt>::FibPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
-: gt(tgt != nullptr ? tgt : cgt) {
-	if(gt == nullptr)
-		throw TemplateFunctionError("FibPriorityQueue::Iterable constructor: neither specified");
-	if(tgt != nullptr && cgt != nullptr && tgt != cgt)
-		throw TemplateFunctionError("FibPriorityQueue::Iterable constructor: both specified and different");
+FibPriorityQueue<T,tgt,Compare>::FibPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "FibPriorityQueue::Iterable constructor");
 
 	for(const T& element : i) enqueue(element);
 	consolidateRank();
@@ -227,118 +433,285 @@ FibPriorityQueue<T,tgt>::FibPriorityQueue(const Iterable& i, bool (*cgt)(const T
 //
 //Queries
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool FibPriorityQueue<T,tgt>::empty() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::empty() const {
 	return nodeCount == 0; 
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-int FibPriorityQueue<T,tgt>::size() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::size() const {
 	return nodeCount;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T& FibPriorityQueue<T,tgt>::peek() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& FibPriorityQueue<T,tgt,Compare>::peek() const {
 	if(empty()) throw EmptyError("FibPriorityQueue::peek"); 
 	return headRootNode->getValue();
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::string FibPriorityQueue<T,tgt>::str() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::try_peek(T*& top) const {
+	if(empty()) return false;
+	top = &headRootNode->getValue();
+	return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+const FibQueueStats& FibPriorityQueue<T,tgt,Compare>::stats() const {
+	return statistics;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::reset_stats() {
+	if(queue_stats) statistics.reset();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string FibPriorityQueue<T,tgt,Compare>::str() const {
 	std::ostringstream answer;
 	answer << "FibPriorityQueue:" << std::endl;
 	answer << "[R]" << std::endl;
 
 	std::string prefix = " │  ";
 	if(headRootNode != nullptr) {
-		DLN* currentRootNode = headRootNode;
+		HN* currentRootNode = headRootNode;
 		while(currentRootNode != headRootNode->prevNode) {
 			answer << " ├─ ";
-			printFibBranch(answer, prefix, currentRootNode->heapNode);
+			printFibBranch(answer, prefix, currentRootNode);
 			answer << " │" << std::endl;
 			currentRootNode = currentRootNode->nextNode;
 		}
 		answer << " └─ ";
 		prefix = "    ";
-		printFibBranch(answer, prefix, currentRootNode->heapNode);
+		printFibBranch(answer, prefix, currentRootNode);
 	}
 	answer << "(nodeCount=" << nodeCount << ",modCount=" << modCount << "):" << std::endl;
 	return answer.str();
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Function>
+void FibPriorityQueue<T,tgt,Compare>::for_each(Function f) const {
+	forEachNode([&f] (HN* heapNode) { f(const_cast<const T&>(heapNode->getValue())); });
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class OutputIterator>
+int FibPriorityQueue<T,tgt,Compare>::peek_k(int k, OutputIterator out) const {
+	if(k > nodeCount) k = nodeCount;
+	if(k <= 0) return 0;
+
+	//The frontier holds the roots and the children of every node already written, as a
+	//  binary heap with the highest priority node at front(): exactly the Iterator's walk
+	auto lower = [this] (HN* a, HN* b) { return this->gt(b->getValue(), a->getValue()); };
+	std::vector<HN*> frontier;
+	HN* cursor = headRootNode;
+	do {
+		frontier.push_back(cursor);
+		cursor = cursor->nextNode;
+	} while(cursor != headRootNode);
+	std::make_heap(frontier.begin(), frontier.end(), lower);
+
+	for(int written = 0; written < k; ++written) {
+		HN* current = frontier.front();
+		std::pop_heap(frontier.begin(), frontier.end(), lower);
+		frontier.pop_back();
+		*out = const_cast<const T&>(current->getValue());
+		++out;
+
+		HN* childNode = current->getChild();
+		for(int i = current->getDegree(); i > 0; --i, childNode = childNode->nextNode) {
+			frontier.push_back(childNode);
+			std::push_heap(frontier.begin(), frontier.end(), lower);
+		}
+	}
+	return k;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-int FibPriorityQueue<T,tgt>::enqueue(const T& element) {
-	HN* tempHeapNode = new HN(element);
-	DLN* tempRootNode = new DLN(tempHeapNode);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::enqueue(const T& element) {
+	enqueueNode(newHeapNode(element));
+	return 1;
+}
 
-	if(headRootNode == nullptr) {
-		headRootNode = tempRootNode;
-	} else {
-		addRootNode(headRootNode, tempRootNode);	
-	}
 
-	if(gt(tempRootNode->getValue(), headRootNode->getValue())) {
-		headRootNode = tempRootNode;
-	}
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::enqueue(T&& element) {
+	enqueueNode(newHeapNode(std::move(element)));
+	return 1;
+}
 
-	++nodeCount; 
-	++modCount;
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::enqueue(const T& element, Handle& handle) {
+	handle = Handle(enqueueNode(newHeapNode(element)));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::enqueue(T&& element, Handle& handle) {
+	handle = Handle(enqueueNode(newHeapNode(std::move(element))));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class... Args>
+int FibPriorityQueue<T,tgt,Compare>::emplace(Args&&... args) {
+	enqueueNode(newHeapNode(std::forward<Args>(args)...));
 	return 1;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T FibPriorityQueue<T,tgt>::dequeue() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T FibPriorityQueue<T,tgt,Compare>::dequeue() {
 	if (this->empty())
 		throw EmptyError("FibPriorityQueue::dequeue");
 
-	T headValue = headRootNode->getValue();
+	T headValue = std::move(headRootNode->getValue());
+	removeHeadRootNode();
+	++modCount;
 
-	DLN* tempRootNode = nullptr;
-	for(HN* currentChild : headRootNode->getChildNodes()) {
-		currentChild->setParent(currentChild);
-		currentChild->setUnmarked();
-		tempRootNode = new DLN(currentChild);
-		addRootNode(headRootNode, tempRootNode);
-	}
+	consolidateRank();
+	return headValue;
+}
 
-	DLN* oldHeadRootNode = headRootNode;
-	headRootNode = headRootNode->nextNode;
-	if(headRootNode == oldHeadRootNode) {
-		headRootNode = nullptr;
-	} else {
-		removeRootNode(oldHeadRootNode);
-	}
 
-	delete oldHeadRootNode->heapNode;
-	delete oldHeadRootNode;
-	--nodeCount;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::try_dequeue(T& top) {
+	if(empty()) return false;
+
+	top = std::move(headRootNode->getValue());
+	removeHeadRootNode();
 	++modCount;
 
 	consolidateRank();
-	return headValue;
+	return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class OutputIterator>
+int FibPriorityQueue<T,tgt,Compare>::dequeue_n(int n, OutputIterator out) {
+	return dequeueWhile(n, [] (const T&) { return true; }, out);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Predicate, class OutputIterator>
+int FibPriorityQueue<T,tgt,Compare>::drain_while(Predicate pred, OutputIterator out) {
+	return dequeueWhile(nodeCount, pred, out);
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::clear() {
-	destroyFibTree(headRootNode);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::clear() {
+	releaseFibTree();
 	headRootNode = nullptr;
+	resetIncremental(false);
 	nodeCount = 0;
 	++modCount;
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::increase_priority(const Handle& handle, const T& newValue) {
+	if(this->gt(handle.heapNode->getValue(), newValue)) return 0;
+
+	increaseKey(handle.heapNode, newValue);
+	if(consolidationBudget != 0) consolidateSteps();
+	++modCount;
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::increase_priority(const Handle& handle, T&& newValue) {
+	if(this->gt(handle.heapNode->getValue(), newValue)) return 0;
+
+	increaseKey(handle.heapNode, std::move(newValue));
+	if(consolidationBudget != 0) consolidateSteps();
+	++modCount;
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T FibPriorityQueue<T,tgt,Compare>::erase(const Handle& handle) {
+	return eraseNode(handle.heapNode);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::merge(FibPriorityQueue<T,tgt,Compare>& q2) {
+	if(!this->same_gt(q2))
+		throw TemplateFunctionError("FibPriorityQueue::merge: different gt functions");
+	if(this == &q2 || q2.empty()) return 0;
+
+	int count = q2.nodeCount;
+	//q2's nodes can only change hands along with their storage
+	if(pool != q2.pool) {
+		if(!q2.ownsPool) {
+			//q2's nodes stay in its shared Pool, so handles into q2 are invalidated by the clear
+			q2.forEachNode([this] (HN* heapNode) { enqueue(std::move(heapNode->getValue())); });
+			q2.clear();
+			return count;
+		}
+		if(pool == nullptr) pool = new Pool();
+		pool->heapNodes.adopt(q2.pool->heapNodes);
+	}
+
+	HN* q2LastRootNode = q2.headRootNode->prevNode;
+	if(headRootNode == nullptr) {
+		headRootNode = q2.headRootNode;
+	} else {
+		//splice q2's root list in before the head (right after the pending roots, if incremental)
+		HN* nextRootNode = consolidationBudget != 0 && pendingRootNode != nullptr ? lastPendingRootNode->nextNode : headRootNode;
+		HN* lastRootNode = nextRootNode->prevNode;
+		lastRootNode->nextNode = q2.headRootNode;
+		q2.headRootNode->prevNode = lastRootNode;
+		q2LastRootNode->nextNode = nextRootNode;
+		nextRootNode->prevNode = q2LastRootNode;
+
+		if(this->gt(q2.headRootNode->getValue(), headRootNode->getValue()))
+			headRootNode = q2.headRootNode;
+	}
+	//q2's roots join the pending run, to be absorbed by later calls
+	if(consolidationBudget != 0) {
+		if(pendingRootNode == nullptr) pendingRootNode = q2.headRootNode;
+		lastPendingRootNode = q2LastRootNode;
+	}
+	nodeCount += count;
+	++modCount;
+
+	q2.resetIncremental(false);
+	q2.headRootNode = nullptr;
+	q2.nodeCount = 0;
+	++q2.modCount;
+	return count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::meld(FibPriorityQueue<T,tgt,Compare>&& q2) {
+	return merge(q2);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
 template <class Iterable>
-int FibPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+int FibPriorityQueue<T,tgt,Compare>::enqueue_all (const Iterable& i) {
  	int count = 0;
  	for (const T& v : i)
 		count += enqueue(v);
@@ -347,38 +720,87 @@ int FibPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
 }
 
 
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::set_parallelism(int threads) {
+	if(threads == 0) threads = std::thread::hardware_concurrency();
+	threadCount = threads < 1 ? 1 : threads;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::set_background_release(bool background) {
+	backgroundRelease = background;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::set_consolidation_budget(int steps) {
+	bool wasIncremental = consolidationBudget != 0;
+	consolidationBudget = steps < 0 ? 0 : steps;
+	//switching on, every root starts out pending; switching off, rankTable is scratch again
+	if(!wasIncremental || consolidationBudget == 0) resetIncremental(true);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>& FibPriorityQueue<T,tgt>::operator = (const FibPriorityQueue<T,tgt>& rhs) {	
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>& FibPriorityQueue<T,tgt,Compare>::operator = (const FibPriorityQueue<T,tgt,Compare>& rhs) {	
 	//check if it is assigning into itself
 	if(this == &rhs) return *this;
 	
 	//delete current fib tree
-	destroyFibTree(headRootNode);
+	destroyFibTree(headRootNode, nodeCount);
 	
 	//make copy of rhs fib tree
-	headRootNode = copyFibTree(rhs.headRootNode);
+	headRootNode = copyFibTree(rhs.headRootNode, rhs.nodeCount);
 	
-	//update current fib tree's info
+	//update current fib tree's info (its old nodes are gone: fail fast in iterators)
 	nodeCount = rhs.nodeCount;
-	gt = rhs.gt;
+	this->assign_gt(rhs);
+	resetIncremental(true);
+	++modCount;
 	return *this;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool FibPriorityQueue<T,tgt>::operator == (const FibPriorityQueue<T,tgt>& rhs) const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>& FibPriorityQueue<T,tgt,Compare>::operator = (FibPriorityQueue<T,tgt,Compare>&& rhs) {
+	if(this == &rhs) return *this;
+
+	//release current fib tree (and an owned pool), then take over rhs's
+	destroyFibTree(headRootNode, nodeCount);
+	if(ownsPool) delete pool;
+
+	this->assign_gt(rhs);
+	nodeCount = rhs.nodeCount;
+	headRootNode = rhs.headRootNode;
+	pool = rhs.pool;
+	ownsPool = rhs.ownsPool;
+	++modCount;
+
+	if(rhs.ownsPool) rhs.pool = nullptr;
+	resetIncremental(true);
+	rhs.resetIncremental(false);
+	rhs.headRootNode = nullptr;
+	rhs.nodeCount = 0;
+	++rhs.modCount;
+	return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::operator == (const FibPriorityQueue<T,tgt,Compare>& rhs) const {
 	//check if current comparing itself
 	if(this == &rhs) return true;
 	
 	//check if gt function are the same
-	if(this->gt != rhs.gt) return false;
+	if(!this->same_gt(rhs)) return false;
 	
 	if(nodeCount != rhs.nodeCount) return false;
-	FibPriorityQueue<T,tgt>::Iterator left = this->begin(), right = rhs.begin();
+	FibPriorityQueue<T,tgt,Compare>::Iterator left = this->begin(), right = rhs.begin();
 	for(; left != this->end(); ++left, ++right)
 		if (*left != *right)
 			return false;
@@ -386,14 +808,14 @@ bool FibPriorityQueue<T,tgt>::operator == (const FibPriorityQueue<T,tgt>& rhs) c
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool FibPriorityQueue<T,tgt>::operator != (const FibPriorityQueue<T,tgt>& rhs) const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::operator != (const FibPriorityQueue<T,tgt,Compare>& rhs) const {
 	return !(*this == rhs);
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T,tgt>& p) {	
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T,tgt,Compare>& p) {	
 	outs << "priority_queue[";
 
 	if (!p.empty()) {
@@ -412,23 +834,29 @@ std::ostream& operator << (std::ostream& outs, const FibPriorityQueue<T,tgt>& p)
 //
 //Iterator constructors
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto FibPriorityQueue<T,tgt>::begin () const -> FibPriorityQueue<T,tgt>::Iterator {
-	return Iterator(const_cast<FibPriorityQueue<T,tgt>*>(this), true);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto FibPriorityQueue<T,tgt,Compare>::begin () const -> FibPriorityQueue<T,tgt,Compare>::Iterator {
+	return Iterator(const_cast<FibPriorityQueue<T,tgt,Compare>*>(this), nodeCount);
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto FibPriorityQueue<T,tgt>::end () const -> FibPriorityQueue<T,tgt>::Iterator {
-	return Iterator(const_cast<FibPriorityQueue<T,tgt>*>(this));	//Create empty pq (size == 0)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto FibPriorityQueue<T,tgt,Compare>::end () const -> FibPriorityQueue<T,tgt,Compare>::Iterator {
+	return Iterator(const_cast<FibPriorityQueue<T,tgt,Compare>*>(this), 0);	//Create empty pq (size == 0)
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Private helper methods
-template<class T, bool (*tgt)(const T& a, const T& b)>
-inline void FibPriorityQueue<T,tgt>::addRootNode(DLN* nextRootNode, DLN* toAdd) {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline bool FibPriorityQueue<T,tgt,Compare>::gt(const T& a, const T& b) const {
+	if(queue_stats) ++statistics.comparisons;
+	return Gt::gt(a, b);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::addRootNode(HN* nextRootNode, HN* toAdd) {
 	nextRootNode->prevNode->nextNode = toAdd;
 	toAdd->nextNode = nextRootNode;
 
@@ -436,198 +864,612 @@ inline void FibPriorityQueue<T,tgt>::addRootNode(DLN* nextRootNode, DLN* toAdd)
 	nextRootNode->prevNode = toAdd;
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-inline void FibPriorityQueue<T,tgt>::addRootNode(DLN* nextRootNode, DLN* toAdd) const {
-	nextRootNode->prevNode->nextNode = toAdd;
-	toAdd->nextNode = nextRootNode;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class... Args>
+inline typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::newHeapNode(Args&&... args) {
+	if(pool == nullptr) pool = new Pool();
+	if(queue_stats) ++statistics.allocations;
+	return new (pool->heapNodes.allocate()) HN(std::forward<Args>(args)...);
+}
 
-	toAdd->prevNode = nextRootNode->prevNode;
-	nextRootNode->prevNode = toAdd;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::deleteHeapNode(HN* toDelete) {
+	if(queue_stats) ++statistics.frees;
+	toDelete->~HN();
+	pool->heapNodes.deallocate(toDelete);
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-inline void FibPriorityQueue<T,tgt>::removeRootNode(DLN* toRemove){
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::removeRootNode(HN* toRemove){
 	toRemove->prevNode->nextNode = toRemove->nextNode;
 	toRemove->nextNode->prevNode = toRemove->prevNode;
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::consolidateRank() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::removeHeadRootNode(){
+	promoteChildren(headRootNode);
+	if(consolidationBudget != 0) forgetRootNode(headRootNode);
+
+	HN* oldHeadRootNode = headRootNode;
+	headRootNode = headRootNode->nextNode;
+	if(headRootNode == oldHeadRootNode) {
+		headRootNode = nullptr;
+	} else {
+		removeRootNode(oldHeadRootNode);
+	}
+
+	deleteHeapNode(oldHeadRootNode);
+	--nodeCount;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::replaceRootNode(HN* toReplace, HN* replacement){
+	//select instead of branching when toReplace is alone in the root list
+	HN* prevRootNode = selectNode(toReplace->prevNode == toReplace, replacement, toReplace->prevNode);
+	HN* nextRootNode = selectNode(toReplace->nextNode == toReplace, replacement, toReplace->nextNode);
+	replacement->prevNode = prevRootNode;
+	replacement->nextNode = nextRootNode;
+	prevRootNode->nextNode = replacement;
+	nextRootNode->prevNode = replacement;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::selectNode(bool first, HN* a, HN* b) {
+	return selectNode(first, a, b, std::is_arithmetic<T>());
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::selectNode(bool first, HN* a, HN* b, std::true_type) {
+	std::uintptr_t mask = -static_cast<std::uintptr_t>(first);
+	return reinterpret_cast<HN*>((reinterpret_cast<std::uintptr_t>(a) & mask) | (reinterpret_cast<std::uintptr_t>(b) & ~mask));
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::selectNode(bool first, HN* a, HN* b, std::false_type) {
+	return first ? a : b;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::enqueueNode(HN* tempRootNode) {
+	addNewRootNode(tempRootNode);
+
+	headRootNode = selectNode(this->gt(tempRootNode->getValue(), headRootNode->getValue()), tempRootNode, headRootNode);
+
+	++nodeCount; 
+	++modCount;
+	if(consolidationBudget != 0) consolidateSteps();
+	return tempRootNode;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::consolidateRank() {
 	if(headRootNode == nullptr || headRootNode->nextNode == headRootNode) return;
+	if(consolidationBudget != 0) {
+		consolidateSteps();
+		findHeadRootNode();
+		return;
+	}
+
+	if(nodeCount >= rankTableLimit) growRankTable();
 
 	int currentRank = -1;
-	T headValue = headRootNode->getValue();
-	DLN* stopRootNode = headRootNode;
-	DLN* currentRootNode = headRootNode;
-	DLN* rankArray[static_cast<int>(log2(nodeCount)) + 1] = { nullptr };
+	int maxRank = 0;
+	int rootCount = 0;
+	HN* stopRootNode = headRootNode;
+	HN* currentRootNode = headRootNode;
+	HN** rankArray = rankTable.data();
 
 	//iterate through all root nodes
 	do {
-		currentRank = currentRootNode->getChildNodes().size();
+		currentRank = currentRootNode->getDegree();
 
 		//merge fib branches until branch has unique rank
 		while(rankArray[currentRank] != nullptr) {
-			if(gt(rankArray[currentRank]->getValue(), currentRootNode->getValue())) {
-				std::swap(rankArray[currentRank]->heapNode, currentRootNode->heapNode);
-			}
-
-			currentRootNode->addChild(rankArray[currentRank]->heapNode);
-			rankArray[currentRank]->heapNode->setParent(currentRootNode->heapNode);
+			HN* otherRootNode = rankArray[currentRank];
 
-			//move stopRootNode forward if it is going to be deleted
-			if(rankArray[currentRank] == stopRootNode) {
+			//move stopRootNode forward if it is going to leave the root list
+			if(otherRootNode == stopRootNode) {
 				stopRootNode = stopRootNode->nextNode;
 			}
-
-			removeRootNode(rankArray[currentRank]);
-			delete rankArray[currentRank];
+			removeRootNode(otherRootNode);
+
+			//the winner takes currentRootNode's place in the root list (selected, not branched on)
+			bool otherWins = this->gt(otherRootNode->getValue(), currentRootNode->getValue());
+			HN* winnerRootNode = selectNode(otherWins, otherRootNode, currentRootNode);
+			HN* loserRootNode = selectNode(otherWins, currentRootNode, otherRootNode);
+			replaceRootNode(currentRootNode, winnerRootNode);
+			stopRootNode = selectNode(currentRootNode == stopRootNode, winnerRootNode, stopRootNode);
+			currentRootNode = winnerRootNode;
+
+			currentRootNode->addChild(loserRootNode);
+			loserRootNode->setParent(currentRootNode);
 			rankArray[currentRank++] = nullptr;
+			if(queue_stats) ++statistics.links;
 		}
 
 		//update headRootNode to point to max value
-		if(!gt(headValue, currentRootNode->getValue())) {
-			headRootNode = currentRootNode;
-			headValue = currentRootNode->getValue();
-		}
+		headRootNode = selectNode(this->gt(headRootNode->getValue(), currentRootNode->getValue()), headRootNode, currentRootNode);
 
 		//save unique fib branch in the rank array
 		rankArray[currentRank] = currentRootNode;
+		if(currentRank > maxRank) maxRank = currentRank;
 		currentRootNode = currentRootNode->nextNode;
+		++rootCount;
 	} while(currentRootNode != stopRootNode);
+
+	//every root is current once (a linked loser was current before it entered rankArray)
+	if(queue_stats) {
+		++statistics.consolidations;
+		statistics.roots += rootCount;
+		if(rootCount > statistics.maxRoots) statistics.maxRoots = rootCount;
+		if(maxRank > statistics.maxDegree) statistics.maxDegree = maxRank;
+	}
+
+	//leave the table empty for the next call
+	std::fill(rankArray, rankArray + maxRank + 1, nullptr);
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-typename FibPriorityQueue<T,tgt>::DLN* FibPriorityQueue<T,tgt>::copyFibTree(DLN* originalTree) const {
-	DLN* cursor = originalTree;
-	if(cursor == nullptr) return cursor;
-	//add headRootNode in order to use addRootNode
-	//also make a deep copy of the fib branch and connect it to the root
-	DLN* returnHeadRootNode = new DLN(copyFibBranch(cursor->heapNode,cursor->heapNode));	
-	cursor = cursor->nextNode;
-
-	//traverse through every root node and add to the doublely linked list copy
-	while(cursor != originalTree)	{	
-		//make a deep copy of fib branch at cursor and connect to root
-		DLN* tempRootNode = new DLN(copyFibBranch(cursor->heapNode, cursor->heapNode));
-		//connect this hanging root node to the doublely linked list
-		addRootNode(returnHeadRootNode, tempRootNode);
-		cursor = cursor->nextNode;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::consolidateSteps() {
+	if(nodeCount >= rankTableLimit) growRankTable();
+	int steps = 2*addedRootCount > consolidationBudget ? 2*addedRootCount : consolidationBudget;
+	addedRootCount = 0;
+	HN** rankArray = rankTable.data();
+
+	//consolidateRank's loop, one step per call of the body: the carry is linked with the placed
+	//  root of its degree (if any) until its degree is free, then placed
+	for(; steps > 0; --steps) {
+		if(carryRootNode == nullptr) {
+			if(pendingRootNode == nullptr) return;
+			carryRootNode = pendingRootNode;
+			if(pendingRootNode == lastPendingRootNode) pendingRootNode = lastPendingRootNode = nullptr;
+			else pendingRootNode = pendingRootNode->nextNode;
+		}
+
+		int currentRank = carryRootNode->getDegree();
+		HN* otherRootNode = rankArray[currentRank];
+		if(otherRootNode == nullptr) {
+			rankArray[currentRank] = carryRootNode;
+			carryRootNode = nullptr;
+			continue;
+		}
+		rankArray[currentRank] = nullptr;
+
+		bool otherWins = this->gt(otherRootNode->getValue(), carryRootNode->getValue());
+		HN* winnerRootNode = selectNode(otherWins, otherRootNode, carryRootNode);
+		HN* loserRootNode = selectNode(otherWins, carryRootNode, otherRootNode);
+		removeRootNode(loserRootNode);
+		winnerRootNode->addChild(loserRootNode);
+		loserRootNode->setParent(winnerRootNode);
+		//on a tie the head may lose: the winner is just as good
+		headRootNode = selectNode(loserRootNode == headRootNode, winnerRootNode, headRootNode);
+		carryRootNode = winnerRootNode;
+		if(queue_stats) {
+			++statistics.links;
+			if(currentRank + 1 > statistics.maxDegree) statistics.maxDegree = currentRank + 1;
+		}
 	}
-	return returnHeadRootNode;
 }
-	
-template<class T, bool (*tgt)(const T& a, const T& b)>
-typename FibPriorityQueue<T,tgt>::HN* FibPriorityQueue<T,tgt>::copyFibBranch(HN* originalBranch, HN* branchParent) const {
-	//traverse recursively through fib branch
-	HN* copyBranch = new HN(originalBranch->getValue());
-	if(originalBranch != branchParent) copyBranch->setParent(branchParent);
-	//make deep copies of the child nodes, else jump to return
-	for(auto childNode : originalBranch->getChildNodes())	
-		copyBranch->addChild(copyFibBranch(childNode, copyBranch));
-	return copyBranch;
-}
-
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::destroyFibTree(DLN* originalTree) {
-	DLN* cursor = originalTree;
-
-	//traverse through doublely linked list 
-	while(cursor != nullptr) {		
-		//delete entire fib heap
-		destroyFibBranch(cursor->heapNode);
-	
-		//delete root node
-		DLN* toDelete = cursor;
-		//if there exist only on branch then set it to null to end loop
-		if(cursor == cursor->nextNode) cursor = nullptr;
-		else cursor = cursor->nextNode;
-		removeRootNode(toDelete);
-		delete toDelete;
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::findHeadRootNode() {
+	HN* stopRootNode = headRootNode;
+	for(HN* cursor = headRootNode->nextNode; cursor != stopRootNode; cursor = cursor->nextNode)
+		headRootNode = selectNode(this->gt(cursor->getValue(), headRootNode->getValue()), cursor, headRootNode);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::addNewRootNode(HN* toAdd) {
+	if(headRootNode == nullptr) headRootNode = toAdd;
+	else if(consolidationBudget == 0 || pendingRootNode == nullptr) addRootNode(headRootNode, toAdd);
+	else addRootNode(lastPendingRootNode->nextNode, toAdd);
+
+	if(consolidationBudget != 0) {
+		if(pendingRootNode == nullptr) pendingRootNode = toAdd;
+		lastPendingRootNode = toAdd;
+		++addedRootCount;
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void FibPriorityQueue<T,tgt,Compare>::forgetRootNode(HN* toForget) {
+	//every root is the carry, placed (in its degree's slot) or pending
+	int rank = toForget->getDegree();
+	if(toForget == carryRootNode) {
+		carryRootNode = nullptr;
+	} else if(rank < int(rankTable.size()) && rankTable[rank] == toForget) {
+		rankTable[rank] = nullptr;
+	} else if(toForget == pendingRootNode) {
+		if(toForget == lastPendingRootNode) pendingRootNode = lastPendingRootNode = nullptr;
+		else pendingRootNode = toForget->nextNode;
+	} else if(toForget == lastPendingRootNode) {
+		lastPendingRootNode = toForget->prevNode;
 	}
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::destroyFibBranch(HN* originalBranch) {	
-	//recursively delete children before deleting node, else delete self
-	for(auto childNode : originalBranch->getChildNodes())	
-		destroyFibBranch(childNode);
-	//delete node
-	delete originalBranch;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::resetIncremental(bool allPending) {
+	std::fill(rankTable.begin(), rankTable.end(), nullptr);
+	carryRootNode = nullptr;
+	addedRootCount = 0;
+	if(allPending && consolidationBudget != 0 && headRootNode != nullptr) {
+		pendingRootNode = headRootNode;
+		lastPendingRootNode = headRootNode->prevNode;
+	} else {
+		pendingRootNode = lastPendingRootNode = nullptr;
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::growRankTable() {
+	//a tree whose root has degree d holds at least F(d+2) nodes, so while nodeCount < F(size+2)
+	//  no degree (even one formed while linking) reaches size; a few spare slots delay regrowth
+	int size = 2;
+	long long fibA = 2, fibB = 3;		//F(size+1), F(size+2)
+	while(fibB <= nodeCount) {
+		long long fibC = fibA + fibB;
+		fibA = fibB;
+		fibB = fibC;
+		++size;
+	}
+	for(int spare = 0; spare < 4; ++spare) {
+		long long fibC = fibA + fibB;
+		fibA = fibB;
+		fibB = fibC;
+		++size;
+	}
+	rankTable.resize(size, nullptr);		//keeps an incremental queue's placed roots
+	rankTableLimit = fibB;
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-typename FibPriorityQueue<T,tgt>::HN* FibPriorityQueue<T,tgt>::findInFibTree(DLN* originalTree, const T& value) const {
-	DLN* cursor = originalTree;
-	HN* heapNode = nullptr;
-	if(cursor == nullptr) return nullptr;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::copyFibTree(HN* originalTree, int originalCount) {
+	if(originalTree == nullptr) return nullptr;
+	if(pool == nullptr) pool = new Pool();
+	if(queue_stats) statistics.allocations += originalCount;
+	int parts = parallelParts(originalTree, originalCount);
+	if(parts == 1) return copyRootRun(originalTree, originalTree, pool->heapNodes);
+
+	//each run of trees is copied into a pool of its own (NodePool is not thread-safe); this
+	//  thread copies the first run. The pools' slabs are then adopted and the runs spliced
+	std::vector<HN*> starts = splitRootList(originalTree, parts);
+	parts = starts.size();
+	std::vector<HN*> copies(parts, nullptr);
+	std::unique_ptr<NodePool<HN>[]> nodes(new NodePool<HN>[parts]);
+	std::vector<std::exception_ptr> errors(parts);
+	auto copyRun = [&] (int i) {
+		try {
+			copies[i] = copyRootRun(starts[i], starts[(i+1) % parts], nodes[i]);
+		} catch(...) {
+			errors[i] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> workers;
+	for(int i = 1; i < parts; ++i)
+		workers.emplace_back(copyRun, i);
+	copyRun(0);
+	for(std::thread& worker : workers)
+		worker.join();
+
+	for(int i = 0; i < parts; ++i)
+		pool->heapNodes.adopt(nodes[i]);
+	for(std::exception_ptr& error : errors)
+		if(error) std::rethrow_exception(error);
+
+	//copies[0] starts with the copy of originalTree, the highest priority root
+	HN* returnHeadRootNode = copies[0];
+	for(int i = 1; i < parts; ++i) {
+		HN* lastRootNode = returnHeadRootNode->prevNode;
+		HN* runLastRootNode = copies[i]->prevNode;
+		lastRootNode->nextNode = copies[i];
+		copies[i]->prevNode = lastRootNode;
+		runLastRootNode->nextNode = returnHeadRootNode;
+		returnHeadRootNode->prevNode = runLastRootNode;
+	}
+	return returnHeadRootNode;
+}
 
-	//traverse through every root node
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename FibPriorityQueue<T,tgt,Compare>::HN* FibPriorityQueue<T,tgt,Compare>::copyRootRun(HN* first, HN* stop, NodePool<HN>& nodes) {
+	HN* returnHeadRootNode = nullptr;
+	HN* rootNode = first;
+
+	//walk each tree in preorder as forEachNode does (no recursion, no stack), copying each
+	//  node as it is reached: copyCursor is its copy. Nodes are allocated in the walk's order,
+	//  so later walks (for_each, copies, the Iterator's descent) run through memory in order
 	do {
-		heapNode = findInFibBranch(cursor->heapNode, value);
-		if(heapNode != nullptr)
-			return heapNode;
+		HN* copyRootNode = new (nodes.allocate()) HN(rootNode->getValue());
+		if(returnHeadRootNode == nullptr) returnHeadRootNode = copyRootNode;
+		else addRootNode(returnHeadRootNode, copyRootNode);
+
+		HN* cursor = rootNode;
+		HN* copyCursor = copyRootNode;
+		for(;;) {
+			HN* childNode = cursor->getChild();
+			if(childNode != nullptr) {
+				cursor = childNode;
+			} else {
+				//climb until some ancestor (below the root) has a sibling not yet copied
+				while(cursor != rootNode && cursor->nextNode == cursor->getParent()->getChild()) {
+					cursor = cursor->getParent();
+					copyCursor = copyCursor->getParent();
+				}
+				if(cursor == rootNode) break;
+				cursor = cursor->nextNode;
+				copyCursor = copyCursor->getParent();
+			}
+			//copy cursor as the last child of copyCursor (so children keep their order)
+			HN* copyNode = new (nodes.allocate()) HN(cursor->getValue());
+			copyNode->setParent(copyCursor);
+			copyCursor->addChild(copyNode);
+			copyCursor = copyNode;
+		}
+		rootNode = rootNode->nextNode;
+	} while(rootNode != stop);
+	return returnHeadRootNode;
+}
 
-		cursor = cursor->nextNode;
-	} while(cursor != originalTree);
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::destroyFibTree(HN* originalTree, int originalCount) {
+	if(queue_stats) statistics.frees += originalCount;
 
-	return nullptr;
+	//nothing to run per node: skip the traversal and just release the slabs below
+	if(ownsPool && std::is_trivially_destructible<HN>::value) originalTree = nullptr;
+
+	//storage is recycled individually only in a shared pool, so only an owned pool goes parallel
+	int parts = ownsPool ? parallelParts(originalTree, originalCount) : 1;
+	if(parts == 1) {
+		destroyRootList(originalTree, ownsPool ? nullptr : &pool->heapNodes);
+	} else {
+		//close each run of trees into a root list of its own, then destroy them concurrently
+		std::vector<HN*> starts = splitRootList(originalTree, parts);
+		parts = starts.size();
+		std::vector<HN*> lasts(parts);
+		for(int i = 0; i < parts; ++i)
+			lasts[i] = starts[(i+1) % parts]->prevNode;
+		for(int i = 0; i < parts; ++i) {
+			lasts[i]->nextNode = starts[i];
+			starts[i]->prevNode = lasts[i];
+		}
+		std::vector<std::thread> workers;
+		for(int i = 1; i < parts; ++i)
+			workers.emplace_back(destroyRootList, starts[i], nullptr);
+		destroyRootList(starts[0], nullptr);
+		for(std::thread& worker : workers)
+			worker.join();
+	}
+
+	//an owned pool holds only this heap's nodes: free its slabs all at once
+	if(ownsPool && pool != nullptr)
+		pool->heapNodes.release();
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-typename FibPriorityQueue<T,tgt>::HN* FibPriorityQueue<T,tgt>::findInFibBranch(HN* originalBranch, const T& value) const {
-	HN* heapNode = nullptr;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::destroyRootList(HN* rootList, NodePool<HN>* recycle) {
+	HN* cursor = rootList;
+
+	//the root list is the work list: each node's children are spliced in right behind it
+	//  before it is destroyed, so every node is reached without recursion or a stack
+	while(cursor != nullptr) {
+		HN* childNode = cursor->getChild();
+		if(childNode != nullptr) {
+			HN* lastChildNode = childNode->prevNode;
+			lastChildNode->nextNode = cursor->nextNode;
+			cursor->nextNode->prevNode = lastChildNode;
+			cursor->nextNode = childNode;
+			childNode->prevNode = cursor;
+		}
 
-	if(originalBranch->getValue() == value) return originalBranch;
-	else if(gt(value, originalBranch->getValue())) return nullptr;
+		HN* toDelete = cursor;
+		if(cursor == cursor->nextNode) cursor = nullptr;
+		else cursor = cursor->nextNode;
+		removeRootNode(toDelete);
 
-	//traverse recursively through fib branch
-	for(auto childNode : originalBranch->getChildNodes()) {
-		heapNode = findInFibBranch(childNode, value);
-		if(heapNode != nullptr)
-			return heapNode;
+		toDelete->~HN();
+		if(recycle != nullptr) recycle->deallocate(toDelete);
 	}
-	return nullptr;
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::increaseKey(HN* toIncrease, const T& newValue) {
-	if(gt(toIncrease->getValue(), newValue)) return;
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::releaseFibTree() {
+	if(!backgroundRelease || !ownsPool || headRootNode == nullptr) {
+		destroyFibTree(headRootNode, nodeCount);
+		return;
+	}
+
+	//the nodes leave along with their storage; an owned pool is recreated on the next enqueue
+	if(queue_stats) statistics.frees += nodeCount;
+	HN* rootList = headRootNode;
+	Pool* oldPool = pool;
+	pool = nullptr;
+	std::thread([rootList, oldPool] () {
+		if(!std::is_trivially_destructible<HN>::value) destroyRootList(rootList, nullptr);
+		delete oldPool;
+	}).detach();
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int FibPriorityQueue<T,tgt,Compare>::parallelParts(HN* rootList, int count) const {
+	if(threadCount == 1 || rootList == nullptr || rootList->nextNode == rootList) return 1;
+	int parts = count / PARALLEL_GRAIN;
+	return parts < 1 ? 1 : parts < threadCount ? parts : threadCount;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::vector<typename FibPriorityQueue<T,tgt,Compare>::HN*> FibPriorityQueue<T,tgt,Compare>::splitRootList(HN* rootList, int parts) {
+	//a root of degree d heads about 2^d nodes (fewer after cuts): each run gets about an equal
+	//  share of the total. There are at most parts runs (fewer if there are too few roots)
+	auto weight = [] (HN* rootNode) { return 1LL << (rootNode->getDegree() < 40 ? rootNode->getDegree() : 40); };
+	long long total = 0;
+	HN* cursor = rootList;
+	do {
+		total += weight(cursor);
+		cursor = cursor->nextNode;
+	} while(cursor != rootList);
+
+	std::vector<HN*> starts(1, rootList);
+	long long sum = 0;
+	for(cursor = rootList; cursor->nextNode != rootList && int(starts.size()) < parts; ) {
+		sum += weight(cursor);
+		cursor = cursor->nextNode;
+		if(sum * parts >= total * (long long)starts.size()) starts.push_back(cursor);
+	}
+	return starts;
+}
 
-	toIncrease->setValue(newValue);	
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class V>
+void FibPriorityQueue<T,tgt,Compare>::increaseKey(HN* toIncrease, V&& newValue) {
+	if(this->gt(toIncrease->getValue(), newValue)) return;
 
-	//special case: toIncrease is connected to a root node
-	if(toIncrease == toIncrease->getParent()) return;
+	toIncrease->setValue(std::forward<V>(newValue));
 
-	//case 1: heap property not violated
-	if(gt((toIncrease->getParent())->getValue(), newValue))	return;
+	//case 2: heap property violated (case 1: not violated, or toIncrease is a root node)
+	if(toIncrease != toIncrease->getParent() && !this->gt((toIncrease->getParent())->getValue(), toIncrease->getValue()))
+		cutToRoot(toIncrease);
 
-	//case 2: heap property violated
-	HN* currentHeapNode = toIncrease;
-	HN* parentHeapNode = toIncrease;
+	if(this->gt(toIncrease->getValue(), headRootNode->getValue())) headRootNode = toIncrease;
+}
 
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::cutToRoot(HN* toCut) {
+	HN* currentHeapNode = toCut;
+	HN* parentHeapNode = toCut;
+	int cutCount = 0;
 
 	do {
 		parentHeapNode = parentHeapNode->getParent();
 		//remove current heap node from parent's child set
-		parentHeapNode->getChildNodes().erase(currentHeapNode);
+		parentHeapNode->removeChild(currentHeapNode);
 
 		//add current heap node to root list
 		currentHeapNode->setParent(currentHeapNode);
-		addRootNode(headRootNode, new DLN(currentHeapNode));
+		addNewRootNode(currentHeapNode);
 
 		//unmark it
 		currentHeapNode->setUnmarked();
 
 		currentHeapNode = parentHeapNode;
+		++cutCount;
 	} while(currentHeapNode->isMarked());
 
+	if(queue_stats) {
+		statistics.cuts += cutCount;
+		statistics.cascadingCuts += cutCount - 1;
+		if(cutCount > statistics.maxCutDepth) statistics.maxCutDepth = cutCount;
+	}
+
 	//mark parent if it's not a root node
-	if(parentHeapNode->getParent() != parentHeapNode) parentHeapNode->setMarked();
+	if(parentHeapNode->getParent() != parentHeapNode) {
+		parentHeapNode->setMarked();
+	} else if(consolidationBudget != 0) {
+		//a placed root that lost a child no longer matches its rankTable slot: pending again
+		int rank = parentHeapNode->getDegree() + 1;
+		if(rank < int(rankTable.size()) && rankTable[rank] == parentHeapNode) {
+			rankTable[rank] = nullptr;
+			removeRootNode(parentHeapNode);
+			addNewRootNode(parentHeapNode);
+		}
+	}
 }
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-void FibPriorityQueue<T,tgt>::printFibBranch(std::ostream& outs, std::string& prefix, HN* currentHeapNode) const {
-	int childCount = currentHeapNode->getChildNodes().size();
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::promoteChildren(HN* parentHeapNode) {
+	//no allocation, just relinking
+	HN* currentChild = parentHeapNode->getChild();
+	for(int i = parentHeapNode->getDegree(); i > 0; --i) {
+		HN* nextChild = currentChild->nextNode;
+		currentChild->setParent(currentChild);
+		currentChild->setUnmarked();
+		if(consolidationBudget != 0) addNewRootNode(currentChild);
+		else addRootNode(parentHeapNode, currentChild);
+		currentChild = nextChild;
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T FibPriorityQueue<T,tgt,Compare>::eraseNode(HN* toErase) {
+	//move toErase to the root list and make it the head, so dequeue removes exactly this node
+	if(toErase != toErase->getParent()) cutToRoot(toErase);
+	headRootNode = toErase;
+	return dequeue();
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T FibPriorityQueue<T,tgt,Compare>::extractNode(HN* toExtract) {
+	//No consolidation: every other node keeps its parent or moves to the root list along with
+	//  its whole subtree, so an Iterator's frontier stays valid
+	if(toExtract != toExtract->getParent()) cutToRoot(toExtract);
+	promoteChildren(toExtract);
+
+	if(consolidationBudget != 0) forgetRootNode(toExtract);
+
+	T value = std::move(toExtract->getValue());
+	if(toExtract->nextNode == toExtract) {
+		headRootNode = nullptr;
+	} else {
+		removeRootNode(toExtract);
+		if(headRootNode == toExtract) {
+			headRootNode = toExtract->nextNode;
+			findHeadRootNode();
+		}
+	}
+
+	deleteHeapNode(toExtract);
+	--nodeCount;
+	++modCount;
+	return value;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Predicate, class OutputIterator>
+int FibPriorityQueue<T,tgt,Compare>::dequeueWhile(int limit, Predicate pred, OutputIterator out) {
+	//dequeue's steps, with the checks and bookkeeping done once per call. Consolidating after
+	//  each value (over the O(log n) roots left by the previous one) beats finding the batch
+	//  by a best-first search (as in peek_k) and consolidating once: see bench "batch"
+	int removed = 0;
+	while(removed < limit && headRootNode != nullptr && pred(const_cast<const T&>(headRootNode->getValue()))) {
+		*out = std::move(headRootNode->getValue());
+		++out;
+
+		removeHeadRootNode();
+		++removed;
+
+		consolidateRank();
+	}
+	if(removed != 0) ++modCount;
+	return removed;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Function>
+void FibPriorityQueue<T,tgt,Compare>::forEachNode(Function f) const {
+	HN* rootNode = headRootNode;
+	if(rootNode == nullptr) return;
+
+	//preorder walk of each tree, steered by the links alone (no stack)
+	do {
+		HN* cursor = rootNode;
+		for(;;) {
+			HN* childNode = cursor->getChild();
+			f(cursor);
+			if(childNode != nullptr) {
+				cursor = childNode;
+				continue;
+			}
+			//climb until some ancestor (below the root) has a sibling not yet visited
+			while(cursor != rootNode && cursor->nextNode == cursor->getParent()->getChild())
+				cursor = cursor->getParent();
+			if(cursor == rootNode) break;
+			cursor = cursor->nextNode;
+		}
+		rootNode = rootNode->nextNode;
+	} while(rootNode != headRootNode);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::printFibBranch(std::ostream& outs, std::string& prefix, HN* currentHeapNode) const {
+	int childCount = currentHeapNode->getDegree();
 
 	if(childCount == 0) {
 		outs << currentHeapNode->getValue() << std::endl;
@@ -649,92 +1491,99 @@ void FibPriorityQueue<T,tgt>::printFibBranch(std::ostream& outs, std::string& pr
 	if(childCount == 1) {
 		newPrefix += "     ";
 		outs << " ─── ";
-		printFibBranch(outs, newPrefix, *(currentHeapNode->getChildNodes().begin()));
+		printFibBranch(outs, newPrefix, currentHeapNode->getChild());
 	}
 	else {
 		newPrefix += "  │  ";
-		ArrayStack<HN*> temp(currentHeapNode->getChildNodes());
+		HN* childNode = currentHeapNode->getChild();
 		outs << " ─┬─ ";
-		printFibBranch(outs, newPrefix, temp.pop());
-		while(temp.size() > 1){
+		printFibBranch(outs, newPrefix, childNode);
+		for(childNode = childNode->nextNode; childNode != currentHeapNode->getChild()->prevNode; childNode = childNode->nextNode) {
 			outs << prefix << padding << "  │" << std::endl;
 			outs << prefix << padding << "  ├─ ";
-			printFibBranch(outs, newPrefix, temp.pop());
+			printFibBranch(outs, newPrefix, childNode);
 		}
 		newPrefix = prefix;
 		newPrefix += padding;
 		newPrefix += "     ";
 		outs << prefix << padding << "  │" << std::endl;
 		outs << prefix << padding << "  └─ ";
-		printFibBranch(outs, newPrefix, temp.pop());
+		printFibBranch(outs, newPrefix, childNode);
 	}
 }
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Iterator class definitions
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::Iterator::Iterator(FibPriorityQueue<T,tgt>* iterateOver, bool fromBegin)
-: it(*iterateOver, iterateOver->gt), refPQ(iterateOver), expectedModCount(iterateOver->modCount) {
-	// Full priority queue; use copy constructor
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::Iterator::Iterator(FibPriorityQueue<T,tgt,Compare>* iterateOver, int remaining)
+: refPQ(iterateOver), remaining(remaining), expectedModCount(iterateOver->modCount) {
+	// Frontier starts as the root list; nodes below are reached as their parents are passed.
+	// An end Iterator's frontier stays empty: beyond the last value
+	if (remaining != 0)
+		restart();
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::Iterator::Iterator(FibPriorityQueue<T,tgt>* iterateOver)
-: it(iterateOver->gt), refPQ(iterateOver), expectedModCount(iterateOver->modCount) {
-	// Empty priority queue; use default constructor (from declaration of "it")
-}
-
-
-template<class T, bool (*tgt)(const T& a, const T& b)>
-FibPriorityQueue<T,tgt>::Iterator::~Iterator()
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+FibPriorityQueue<T,tgt,Compare>::Iterator::~Iterator()
 {}
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T FibPriorityQueue<T,tgt>::Iterator::erase() {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T FibPriorityQueue<T,tgt,Compare>::Iterator::erase() {
 	if (expectedModCount != refPQ->modCount)
 		throw ConcurrentModificationError("FibPriorityQueue::Iterator::erase");
 	if (!canErase)
 		throw CannotEraseError("FibPriorityQueue::Iterator::erase Iterator cursor already erased");
-	if (it.empty())
+	if (frontier.empty())
 		throw CannotEraseError("FibPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
 
 	canErase = false;
-	T toReturn = it.dequeue();
-
-	//Find value from it (heap iterating over) in main heap;
-	HN* toRemove;
-	toRemove = refPQ->findInFibTree(refPQ->headRootNode, toReturn);
-	
-	refPQ->increaseKey(toRemove, refPQ->headRootNode->getValue());
-	refPQ->dequeue();
+	HN* toRemove = frontier.front();
+	if (passed == 0) {
+		//Nothing iterated past remains, so the frontier is just the root list: a full
+		//  erase (which consolidates, keeping later erases cheap) cannot invalidate it
+		T toReturn = refPQ->eraseNode(toRemove);
+		restart();
+		--remaining;
+		expectedModCount = refPQ->modCount;
+		return toReturn;
+	}
 
+	//Consolidation could link a passed node below one in the frontier (revisiting it):
+	//  extract without consolidating
+	advance();
+	--passed;
+	T toReturn = refPQ->extractNode(toRemove);
 	expectedModCount = refPQ->modCount;
-	
 	return toReturn;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-std::string FibPriorityQueue<T,tgt>::Iterator::str() const {
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string FibPriorityQueue<T,tgt,Compare>::Iterator::str() const {
 	std::ostringstream answer;
-	answer << it.str() << "/expectedModCount=" << expectedModCount << "/canErase=" << canErase;
+	answer << refPQ->str() << "/current=";
+	if (frontier.empty())
+		answer << "end";
+	else
+		answer << frontier.front()->getValue();
+	answer << "/remaining=" << remaining << "/expectedModCount=" << expectedModCount << "/canErase=" << canErase;
 	return answer.str();
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto FibPriorityQueue<T,tgt>::Iterator::operator ++ () -> FibPriorityQueue<T,tgt>::Iterator& {
-if (expectedModCount != refPQ->modCount)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto FibPriorityQueue<T,tgt,Compare>::Iterator::operator ++ () -> FibPriorityQueue<T,tgt,Compare>::Iterator& {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
 		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator ++");
 
-	if (it.empty())
+	if (frontier.empty())
 		return *this;
 
 	if (canErase)
-		it.dequeue();
+		advance();
 	else
 		canErase = true;
 
@@ -742,17 +1591,17 @@ if (expectedModCount != refPQ->modCount)
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-auto FibPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> FibPriorityQueue<T,tgt>::Iterator {
-	if (expectedModCount != refPQ->modCount)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto FibPriorityQueue<T,tgt,Compare>::Iterator::operator ++ (int) -> FibPriorityQueue<T,tgt,Compare>::Iterator {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
 		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator ++(int)");
 
-	if (it.empty())
+	if (frontier.empty())
 		return *this;
 
 	Iterator toReturn(*this);
 	if (canErase)
-		it.dequeue();
+		advance();
 	else
 		canErase = true;
 
@@ -760,54 +1609,87 @@ auto FibPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> FibPriorityQueue<T,
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool FibPriorityQueue<T,tgt>::Iterator::operator == (const FibPriorityQueue<T,tgt>::Iterator& rhs) const {
-	const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-	if (rhsASI == 0)
-		throw IteratorTypeError("FibPriorityQueue::Iterator::operator ==");
-	if (expectedModCount != refPQ->modCount)
-		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator ==");
-	if (refPQ != rhsASI->refPQ)
-		throw ComparingDifferentIteratorsError("FibPriorityQueue::Iterator::operator ==");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::Iterator::operator == (const FibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+	if (checked_iterators) {
+		const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+		if (rhsASI == 0)
+			throw IteratorTypeError("FibPriorityQueue::Iterator::operator ==");
+		if (expectedModCount != refPQ->modCount)
+			throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator ==");
+		if (refPQ != rhsASI->refPQ)
+			throw ComparingDifferentIteratorsError("FibPriorityQueue::Iterator::operator ==");
+	}
 
-	//Two iterators on the same heap are equal if their sizes are equal
-	return this->it.size() == rhsASI->it.size();
+	//Two iterators on the same heap are equal if the same number of values remain
+	return this->remaining == rhs.remaining;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-bool FibPriorityQueue<T,tgt>::Iterator::operator != (const FibPriorityQueue<T,tgt>::Iterator& rhs) const {
-	const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
-	if (rhsASI == 0)
-		throw IteratorTypeError("FibPriorityQueue::Iterator::operator !=");
-	if (expectedModCount != refPQ->modCount)
-		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator !=");
-	if (refPQ != rhsASI->refPQ)
-		throw ComparingDifferentIteratorsError("FibPriorityQueue::Iterator::operator !=");
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool FibPriorityQueue<T,tgt,Compare>::Iterator::operator != (const FibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+	if (checked_iterators) {
+		const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+		if (rhsASI == 0)
+			throw IteratorTypeError("FibPriorityQueue::Iterator::operator !=");
+		if (expectedModCount != refPQ->modCount)
+			throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator !=");
+		if (refPQ != rhsASI->refPQ)
+			throw ComparingDifferentIteratorsError("FibPriorityQueue::Iterator::operator !=");
+	}
 
-	return this->it.size() != rhsASI->it.size();
+	return this->remaining != rhs.remaining;
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T& FibPriorityQueue<T,tgt>::Iterator::operator *() const {
-	if (expectedModCount != refPQ->modCount)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& FibPriorityQueue<T,tgt,Compare>::Iterator::operator *() const {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
 		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator *");
-	if (!canErase || it.empty())
+	if (checked_iterators && (!canErase || frontier.empty()))
 		throw IteratorPositionIllegal("FibPriorityQueue::Iterator::operator * Iterator illegal: exhausted");
 
-	return it.peek();
+	return frontier.front()->getValue();
 }
 
 
-template<class T, bool (*tgt)(const T& a, const T& b)>
-T* FibPriorityQueue<T,tgt>::Iterator::operator ->() const {
-	if (expectedModCount != refPQ->modCount)
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T* FibPriorityQueue<T,tgt,Compare>::Iterator::operator ->() const {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
 		throw ConcurrentModificationError("FibPriorityQueue::Iterator::operator *");
-	if (!canErase || it.empty())
+	if (checked_iterators && (!canErase || frontier.empty()))
 		throw IteratorPositionIllegal("FibPriorityQueue::Iterator::operator -> Iterator illegal: exhausted");
 
-	return &it.peek();
+	return &frontier.front()->getValue();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::Iterator::advance() {
+	HN* current = frontier.front();
+	std::pop_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
+	frontier.pop_back();
+
+	HN* childNode = current->getChild();
+	for(int i = current->getDegree(); i > 0; --i, childNode = childNode->nextNode) {
+		frontier.push_back(childNode);
+		std::push_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
+	}
+	--remaining;
+	++passed;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void FibPriorityQueue<T,tgt,Compare>::Iterator::restart() {
+	frontier.clear();
+	HN* cursor = refPQ->headRootNode;
+	if(cursor != nullptr)
+		do {
+			frontier.push_back(cursor);
+			cursor = cursor->nextNode;
+		} while(cursor != refPQ->headRootNode);
+	std::make_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
 }
 
 }
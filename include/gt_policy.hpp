@@ -0,0 +1,148 @@
+#ifndef GT_POLICY_HPP_
+#define GT_POLICY_HPP_
+
+#include <string>
+#include <type_traits>
+#include <new>
+#include "courselib/ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//Compare's operator = if it has one, else destroy and copy-construct in place (e.g., a lambda's
+//  closure type, whose operator = is deleted)
+template<class Compare>
+void assignCompare(Compare& to, const Compare& from, std::true_type) { to = from; }
+
+template<class Compare>
+void assignCompare(Compare& to, const Compare& from, std::false_type) {
+	if(&to == &from) return;
+	to.~Compare();
+	::new (static_cast<void*>(&to)) Compare(from);
+}
+
+
+//Holds a Compare object. An empty, non-final class is a base, so it costs no space; anything
+//  else (a function pointer, a final class, a stateful functor) is a member.
+template<class Compare, bool asBase = std::is_empty<Compare>::value && !__is_final(Compare)>	//std::is_final is C++14
+class CompareHolder : private Compare {
+	public:
+		CompareHolder() : Compare() {}
+		explicit CompareHolder(const Compare& compare) : Compare(compare) {}
+		CompareHolder(const CompareHolder& toCopy) : Compare(toCopy.compare()) {}
+		CompareHolder& operator = (const CompareHolder& rhs) {
+			assignCompare(compare(), rhs.compare(), std::is_copy_assignable<Compare>());
+			return *this;
+		}
+
+		const Compare& compare() const { return *this; }
+		Compare&       compare()       { return *this; }
+};
+
+
+template<class Compare>
+class CompareHolder<Compare,false> {
+	public:
+		CompareHolder() : comparator() {}
+		explicit CompareHolder(const Compare& compare) : comparator(compare) {}
+		CompareHolder(const CompareHolder& toCopy) : comparator(toCopy.comparator) {}
+		CompareHolder& operator = (const CompareHolder& rhs) {
+			assignCompare(comparator, rhs.comparator, std::is_copy_assignable<Compare>());
+			return *this;
+		}
+
+		const Compare& compare() const { return comparator; }
+		Compare&       compare()       { return comparator; }
+
+	private:
+		Compare comparator;
+};
+
+
+//Supplies gt(a,b) (true, iff a has higher priority than b) to a priority queue that derives from it.
+//Compare == void: the tgt/cgt function-pointer protocol (see the queues). When tgt is supplied
+//  it is a compile-time constant, so calls through gt are direct (and inlinable).
+//Compare != void: any callable type (e.g., std::less<T>, a functor, a lambda, a function pointer)
+//  whose operator()(a,b) (const, for a class) means gt(a,b). It is held by a CompareHolder, so
+//  an empty Compare costs no space; tgt must be nullptr and cgt must not be supplied. Two
+//  Compare objects order values the same way if they are ==, or (with no operator ==) if
+//  Compare is empty: a stateful Compare needs operator == to merge, copy the heap shape of,
+//  or == another queue.
+//Compare == bool (*)(const T& a, const T& b), the type of cgt itself, is the cgt protocol: the
+//  function is supplied to the constructor as cgt (see the specialization below).
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+class GtPolicy : private CompareHolder<Compare> {
+	static_assert(tgt == nullptr, "GtPolicy: supply either tgt or a Compare type, not both");
+
+	public:
+		typedef Compare Comparator;
+
+		GtPolicy(bool (*)(const T& a, const T& b)) {}
+		GtPolicy(bool (*)(const T& a, const T& b), const GtPolicy& fallback) : CompareHolder<Compare>(fallback) {}
+		explicit GtPolicy(const Compare& compare) : CompareHolder<Compare>(compare) {}
+
+		bool gt(const T& a, const T& b) const { return this->compare()(a, b); }
+
+		bool same_gt	(const GtPolicy& other) const {
+			return this == &other || sameCompare(this->compare(), other.compare(), 0);
+		}
+		void assign_gt	(const GtPolicy& other) { CompareHolder<Compare>::operator = (other); }
+
+		void check_gt(bool (*cgt)(const T& a, const T& b), const std::string& where) const {
+			if (cgt != nullptr)
+				throw TemplateFunctionError(where + ": cgt specified with a Compare type");
+			if (isNull(this->compare(), std::is_pointer<Compare>()))
+				throw TemplateFunctionError(where + ": null function pointer Compare");
+		}
+
+	private:
+		//Compare's operator == if it has one (the int overload is preferred), else whether it is empty
+		template<class C>
+		static auto sameCompare(const C& a, const C& b, int) -> decltype(bool(a == b)) { return a == b; }
+		template<class C>
+		static bool sameCompare(const C&, const C&, long) { return std::is_empty<C>::value; }
+
+		static bool isNull(const Compare& compare, std::true_type)	{ return compare == nullptr; }
+		static bool isNull(const Compare&, std::false_type)		{ return false; }
+};
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+class GtPolicy<T,tgt,void> {
+	public:
+		struct Comparator {};		//No Compare type: the queues' Compare constructor is unusable
+
+		GtPolicy(bool (*cgt)(const T& a, const T& b)) : gtFunction(tgt != nullptr ? tgt : cgt) {}
+		GtPolicy(bool (*cgt)(const T& a, const T& b), const GtPolicy& fallback)
+		: gtFunction(tgt != nullptr ? tgt : cgt != nullptr ? cgt : fallback.gtFunction) {}
+
+		bool gt(const T& a, const T& b) const { return tgt != nullptr ? tgt(a, b) : gtFunction(a, b); }
+
+		bool same_gt	(const GtPolicy& other) const { return gtFunction == other.gtFunction; }
+		void assign_gt	(const GtPolicy& other) { gtFunction = other.gtFunction; }
+
+		void check_gt(bool (*cgt)(const T& a, const T& b), const std::string& where) const {
+			if (gtFunction == nullptr)
+				throw TemplateFunctionError(where + ": neither specified");
+			if (tgt != nullptr && cgt != nullptr && tgt != cgt)
+				throw TemplateFunctionError(where + ": both specified and different");
+		}
+
+	private:
+		bool (*gtFunction) (const T& a, const T& b);	// The gt used by the queue (from template or constructor)
+};
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+class GtPolicy<T,tgt,bool (*)(const T& a, const T& b)> : public GtPolicy<T,nullptr,void> {
+	static_assert(tgt == nullptr, "GtPolicy: supply either tgt or a Compare type, not both");
+
+	public:
+		GtPolicy(bool (*cgt)(const T& a, const T& b)) : GtPolicy<T,nullptr,void>(cgt) {}
+		GtPolicy(bool (*cgt)(const T& a, const T& b), const GtPolicy& fallback) : GtPolicy<T,nullptr,void>(cgt, fallback) {}
+};
+
+}
+
+#endif /* GT_POLICY_HPP_ */
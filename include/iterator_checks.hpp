@@ -0,0 +1,23 @@
+#ifndef ITERATOR_CHECKS_HPP_
+#define ITERATOR_CHECKS_HPP_
+
+
+namespace ics {
+
+
+//By default every container Iterator fails fast: ++, ==, !=, * and -> raise
+//  ConcurrentModificationError, IteratorTypeError, ComparingDifferentIteratorsError or
+//  IteratorPositionIllegal when misused.
+//Compiling with -DICS_UNCHECKED_ITERATORS makes checked_iterators false, so the optimizer
+//  removes those checks (and the dynamic_cast in == and !=) from the loop: misuse is then
+//  undefined behavior. Iterator::erase is always checked.
+//Every translation unit of a program must be compiled the same way.
+#ifdef ICS_UNCHECKED_ITERATORS
+const bool checked_iterators = false;
+#else
+const bool checked_iterators = true;
+#endif
+
+}
+
+#endif /* ITERATOR_CHECKS_HPP_ */
@@ -0,0 +1,254 @@
+#ifndef KEYED_FIB_PRIORITY_QUEUE_HPP_
+#define KEYED_FIB_PRIORITY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include "courselib/ics_exceptions.hpp"
+#include "pair.hpp"
+#include "gt_policy.hpp"
+#include "fib_priority_queue.hpp"
+namespace ics {
+
+
+//A FibPriorityQueue of (Key,Value) elements ordered by Key alone.
+//The heap nodes hold only the key and the index of the value's slot in a side array, so
+//  consolidation and the other comparison-heavy paths touch small, dense nodes; a Value
+//  is read (moved) only by peek/dequeue/erase.
+//The key's gt is supplied exactly as FibPriorityQueue's: tgt(a,b) in the template, cgt(a,b)
+//  in a constructor, or a Compare type (see gt_policy.hpp); errors raise TemplateFunctionError.
+//Value must be copyable: peek/dequeue/erase return an ics::pair.
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b) = nullptr, class Compare = void>
+class KeyedFibPriorityQueue {
+	private:
+		typedef GtPolicy<Key,tgt,Compare> KeyGt;
+
+		//What the heap stores: a key and the slot of its value in payloads
+		struct Entry {
+			Key key;
+			int slot;
+			friend std::ostream& operator << (std::ostream& outs, const Entry& e) { return outs << e.key << "@" << e.slot; }
+		};
+
+		//Orders Entries by the queue's key gt
+		class EntryOrder : private KeyGt {
+			public:
+				explicit EntryOrder(const KeyGt& keyGt) : KeyGt(keyGt) {}
+				bool operator () (const Entry& a, const Entry& b) const { return this->gt(a.key, b.key); }
+		};
+
+		typedef FibPriorityQueue<Entry,nullptr,EntryOrder> EntryQueue;
+
+	public:
+		//Destructor/Constructors
+		KeyedFibPriorityQueue(bool (*cgt)(const Key& a, const Key& b) = nullptr);
+		explicit KeyedFibPriorityQueue(const typename KeyGt::Comparator& compare);	//Compare != void only
+		//Copy/move construction and assignment are the memberwise defaults
+
+
+		//Queries
+		bool empty		() const;
+		int	size		() const;
+		ics::pair<Key,Value> peek	() const;		//copies of the highest priority key and its value
+		const Key&	peek_key		() const;
+		Value&		peek_value		() const;
+		std::string str	() const; //supplies useful debugging information
+
+
+		//Commands
+		class Handle;
+		int	enqueue	(const Key& key, const Value& value);
+		int	enqueue	(const Key& key, Value&& value);
+		int	enqueue	(const Key& key, Value&& value, Handle& handle);	//handle refers to the element until it leaves the queue
+		ics::pair<Key,Value> dequeue	();		//moves the value out of the queue
+		void clear	();
+
+		//handle must refer to an element still in this queue
+		int increase_priority		(const Handle& handle, const Key& newKey);	//0 (no change) if newKey has lower priority
+		ics::pair<Key,Value> erase	(const Handle& handle);
+
+		//Stable reference to one enqueued element
+		class Handle {
+			public:
+				const Key&	key		() const { return entry->key; }
+				bool operator == (const Handle& rhs) const { return entry == rhs.entry; }
+				bool operator != (const Handle& rhs) const { return entry != rhs.entry; }
+
+			private:
+				friend class KeyedFibPriorityQueue<Key,Value,tgt,Compare>;
+				typename EntryQueue::Handle entry;
+		};
+
+	private:
+		EntryQueue			entries;			// Heap of (key,slot)
+		std::vector<Value>	payloads;			// Values, by slot; a free slot holds a moved-from Value
+		std::vector<int>	freeSlots;			// Slots available for reuse
+
+		//Helper methods
+		int		storeValue	(Value&& value);
+		Value	releaseValue(int slot);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//KeyedFibPriorityQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+KeyedFibPriorityQueue<Key,Value,tgt,Compare>::KeyedFibPriorityQueue(bool (*cgt)(const Key& a, const Key& b))
+: entries(EntryOrder(KeyGt(cgt))) {
+	KeyGt(cgt).check_gt(cgt, "KeyedFibPriorityQueue::default constructor");
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+KeyedFibPriorityQueue<Key,Value,tgt,Compare>::KeyedFibPriorityQueue(const typename KeyGt::Comparator& compare)
+: entries(EntryOrder(KeyGt(compare))) {
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+bool KeyedFibPriorityQueue<Key,Value,tgt,Compare>::empty() const {
+	return entries.empty();
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::size() const {
+	return entries.size();
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+ics::pair<Key,Value> KeyedFibPriorityQueue<Key,Value,tgt,Compare>::peek() const {
+	if (this->empty())
+		throw EmptyError("KeyedFibPriorityQueue::peek");
+
+	const Entry& top = entries.peek();
+	return ics::pair<Key,Value>(top.key, payloads[top.slot]);
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+const Key& KeyedFibPriorityQueue<Key,Value,tgt,Compare>::peek_key() const {
+	if (this->empty())
+		throw EmptyError("KeyedFibPriorityQueue::peek_key");
+
+	return entries.peek().key;
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+Value& KeyedFibPriorityQueue<Key,Value,tgt,Compare>::peek_value() const {
+	if (this->empty())
+		throw EmptyError("KeyedFibPriorityQueue::peek_value");
+
+	return const_cast<Value&>(payloads[entries.peek().slot]);
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+std::string KeyedFibPriorityQueue<Key,Value,tgt,Compare>::str() const {
+	std::ostringstream answer;
+	answer << "KeyedFibPriorityQueue(slots=" << payloads.size() << ",freeSlots=" << freeSlots.size() << "):" << std::endl
+	       << entries.str();
+	return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::enqueue(const Key& key, const Value& value) {
+	return enqueue(key, Value(value));
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::enqueue(const Key& key, Value&& value) {
+	int slot = storeValue(std::move(value));
+	return entries.enqueue(Entry{key, slot});
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::enqueue(const Key& key, Value&& value, Handle& handle) {
+	int slot = storeValue(std::move(value));
+	return entries.enqueue(Entry{key, slot}, handle.entry);
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+ics::pair<Key,Value> KeyedFibPriorityQueue<Key,Value,tgt,Compare>::dequeue() {
+	if (this->empty())
+		throw EmptyError("KeyedFibPriorityQueue::dequeue");
+
+	Entry top = entries.dequeue();
+	return ics::pair<Key,Value>(top.key, releaseValue(top.slot));
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+void KeyedFibPriorityQueue<Key,Value,tgt,Compare>::clear() {
+	entries.clear();
+	payloads.clear();
+	freeSlots.clear();
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::increase_priority(const Handle& handle, const Key& newKey) {
+	return entries.increase_priority(handle.entry, Entry{newKey, handle.entry->slot});
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+ics::pair<Key,Value> KeyedFibPriorityQueue<Key,Value,tgt,Compare>::erase(const Handle& handle) {
+	Entry erased = entries.erase(handle.entry);
+	return ics::pair<Key,Value>(erased.key, releaseValue(erased.slot));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+int KeyedFibPriorityQueue<Key,Value,tgt,Compare>::storeValue(Value&& value) {
+	if (freeSlots.empty()) {
+		payloads.push_back(std::move(value));
+		return payloads.size() - 1;
+	}
+	int slot = freeSlots.back();
+	freeSlots.pop_back();
+	payloads[slot] = std::move(value);
+	return slot;
+}
+
+
+template<class Key, class Value, bool (*tgt)(const Key& a, const Key& b), class Compare>
+Value KeyedFibPriorityQueue<Key,Value,tgt,Compare>::releaseValue(int slot) {
+	Value value = std::move(payloads[slot]);
+	if (slot == (int)payloads.size() - 1)
+		payloads.pop_back();
+	else
+		freeSlots.push_back(slot);
+	return value;
+}
+
+}
+
+#endif /* KEYED_FIB_PRIORITY_QUEUE_HPP_ */
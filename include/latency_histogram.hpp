@@ -0,0 +1,161 @@
+#ifndef LATENCY_HISTOGRAM_HPP_
+#define LATENCY_HISTOGRAM_HPP_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#if defined(ICS_LATENCY_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>				//__rdtsc
+#define ICS_LATENCY_TICKS_ARE_CYCLES
+#endif
+
+
+namespace ics {
+
+
+//Log-bucketed (HDR-style) histogram of latencies, in ticks of latency_clock.
+//Values below 2*SUB_BUCKETS have a bucket each; above that, every power of two is split into
+//  SUB_BUCKETS equal buckets, so a reported percentile is within 1/SUB_BUCKETS (about 3%) of the
+//  value recorded. Values of 2^MAX_BITS ticks or more share the last bucket (max stays exact).
+//record is O(1) and allocation-free; percentile is O(buckets).
+class LatencyHistogram {
+	public:
+		static const int SUB_BITS	 = 5;
+		static const int SUB_BUCKETS = 1 << SUB_BITS;
+		static const int MAX_BITS	 = 40;			//2^40 ns is about 18 minutes
+		static const int BUCKETS	 = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+		LatencyHistogram() : counts(BUCKETS, 0) {}
+
+		//Queries
+		long long count		() const { return total; }
+		long long min		() const { return total == 0 ? 0 : minimum; }
+		long long max		() const { return maximum; }
+		double	  mean		() const { return total == 0 ? 0 : double(sum) / total; }
+		long long percentile(double p) const;	//p in [0,100]: highest value in p's bucket (0 if empty)
+		std::string str		() const;			//One line: count, mean and the tail percentiles
+
+		//Commands
+		void record	(long long ticks);
+		void merge	(const LatencyHistogram& other);
+		void reset	();
+
+		static int		 bucket		(long long ticks);
+		static long long bucketHigh	(int bucket);	//Highest value counted in bucket
+
+	private:
+		std::vector<long long> counts;
+		long long total		= 0;
+		long long sum		= 0;
+		long long minimum	= 0;
+		long long maximum	= 0;
+};
+
+
+//The clock that LatencyHistogram ticks count: std::chrono::steady_clock nanoseconds, or (when
+//  compiled with -DICS_LATENCY_RDTSC on x86) raw rdtsc cycles, which are cheaper to read.
+//Every translation unit of a program must be compiled the same way.
+struct latency_clock {
+	static long long now() {
+#ifdef ICS_LATENCY_TICKS_ARE_CYCLES
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	static const char* unit() {
+#ifdef ICS_LATENCY_TICKS_ARE_CYCLES
+		return "cycles";
+#else
+		return "ns";
+#endif
+	}
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//LatencyHistogram class and related definitions
+
+inline int LatencyHistogram::bucket(long long ticks) {
+	if(ticks < 0) ticks = 0;
+	if(ticks < 2*SUB_BUCKETS) return int(ticks);
+
+	//shift leaves ticks' SUB_BITS+1 highest bits: ticks >> shift is in [SUB_BUCKETS,2*SUB_BUCKETS)
+	int shift = 0;
+	for(unsigned long long high = (unsigned long long)ticks >> (SUB_BITS + 1); high != 0; high >>= 1)
+		++shift;
+	int answer = (shift + 1)*SUB_BUCKETS + int(ticks >> shift) - SUB_BUCKETS;
+	return answer < BUCKETS ? answer : BUCKETS - 1;
+}
+
+
+inline long long LatencyHistogram::bucketHigh(int bucket) {
+	if(bucket < 2*SUB_BUCKETS) return bucket;
+	int shift = bucket/SUB_BUCKETS - 1;
+	return ((long long)(bucket%SUB_BUCKETS + SUB_BUCKETS + 1) << shift) - 1;
+}
+
+
+inline long long LatencyHistogram::percentile(double p) const {
+	if(total == 0) return 0;
+	//the rank-th smallest value (1-based) is the p-th percentile
+	long long rank = (long long)(p/100*total + 0.5);
+	if(rank < 1) rank = 1;
+	if(rank > total) rank = total;
+
+	long long seen = 0;
+	for(int i = 0; i < BUCKETS; ++i) {
+		seen += counts[i];
+		if(seen >= rank) {
+			long long high = bucketHigh(i);
+			return high < maximum ? high : maximum;
+		}
+	}
+	return maximum;
+}
+
+
+inline std::string LatencyHistogram::str() const {
+	std::ostringstream answer;
+	answer << "LatencyHistogram(count=" << total << ",mean=" << mean() << ",min=" << min()
+	       << ",p50=" << percentile(50) << ",p90=" << percentile(90) << ",p99=" << percentile(99)
+	       << ",p99.9=" << percentile(99.9) << ",p99.99=" << percentile(99.99) << ",max=" << maximum
+	       << "," << latency_clock::unit() << ")";
+	return answer.str();
+}
+
+
+inline void LatencyHistogram::record(long long ticks) {
+	++counts[bucket(ticks)];
+	if(total == 0 || ticks < minimum) minimum = ticks;
+	if(ticks > maximum) maximum = ticks;
+	++total;
+	sum += ticks;
+}
+
+
+inline void LatencyHistogram::merge(const LatencyHistogram& other) {
+	if(other.total == 0) return;
+	for(int i = 0; i < BUCKETS; ++i)
+		counts[i] += other.counts[i];
+	if(total == 0 || other.minimum < minimum) minimum = other.minimum;
+	if(other.maximum > maximum) maximum = other.maximum;
+	total += other.total;
+	sum += other.sum;
+}
+
+
+inline void LatencyHistogram::reset() {
+	counts.assign(BUCKETS, 0);
+	total = sum = minimum = maximum = 0;
+}
+
+}
+
+#endif /* LATENCY_HISTOGRAM_HPP_ */
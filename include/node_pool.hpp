@@ -0,0 +1,204 @@
+#ifndef NODE_POOL_HPP_
+#define NODE_POOL_HPP_
+
+#include <string>
+#include <sstream>
+#include <type_traits>
+#include <new>
+
+
+namespace ics {
+
+
+//Slab allocator handing out uninitialized storage for one Node at a time.
+//Storage is carved out of slabs that double in length (up to MAX_SLAB_LENGTH);
+//  deallocated storage is recycled through an intrusive free list.
+//release() frees every slab at once: callers must have already run the
+//  destructors of any Nodes still living in the pool (or know they are trivial).
+//A pool may be shared by several containers (of the same Node type); it must
+//  outlive all of them. NodePool is not thread-safe.
+template<class Node>
+class NodePool {
+	public:
+		//Destructor/Constructors
+		~NodePool();
+		NodePool(int initial_slab_length = 8);
+		NodePool(const NodePool<Node>& to_copy) = delete;
+		NodePool<Node>& operator = (const NodePool<Node>& rhs) = delete;
+
+		//Queries
+		int slab_count	() const;
+		int capacity	() const;	//Slots carved out of all slabs
+		std::string str	() const;
+
+		//Commands
+		void* allocate	();
+		void  deallocate(void* node);
+		void  release	();
+		//Takes over other's slabs and free list; other becomes empty and its next slab is small again.
+		//O(1), plus threading the unbumped slots of other's current slab onto the free list
+		//  (fewer than MAX_SLAB_LENGTH): every slot counted by capacity() stays usable
+		void  adopt		(NodePool<Node>& other);
+
+		static const int MAX_SLAB_LENGTH = 4096;
+
+	private:
+		union Slot {
+			Slot* next;		//When on the free list (or slot[0] of a slab: link to the previous slab)
+			typename std::aligned_storage<sizeof(Node), std::alignment_of<Node>::value>::type storage;
+		};
+
+		Slot* slabs			= nullptr;	//Most recent slab; slot 0 of each slab links to the previous one
+		Slot* oldestSlab	= nullptr;	//Last slab on the slabs chain, so adopt can splice in O(1)
+		Slot* freeList		= nullptr;	//Recycled slots (most recently freed first)
+		Slot* freeTail		= nullptr;	//Last slot on freeList, so adopt can splice in O(1)
+		int   slabUsed		= 0;		//Slots bumped out of the most recent slab (including the link slot)
+		int   slabLength	= 0;		//Length of the most recent slab (including the link slot)
+		int   nextSlabLength;			//Number of Node slots in the next slab allocated
+		int   initialSlabLength;
+		int   slabCount		= 0;
+		int   slotCount		= 0;
+
+		//Helper methods
+		void addSlab();
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//NodePool class and related definitions
+
+//Destructor/Constructors
+
+template<class Node>
+NodePool<Node>::~NodePool() {
+	release();
+}
+
+
+template<class Node>
+NodePool<Node>::NodePool(int initial_slab_length)
+: nextSlabLength(initial_slab_length < 1 ? 1 : initial_slab_length), initialSlabLength(nextSlabLength) {
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class Node>
+int NodePool<Node>::slab_count() const {
+	return slabCount;
+}
+
+
+template<class Node>
+int NodePool<Node>::capacity() const {
+	return slotCount;
+}
+
+
+template<class Node>
+std::string NodePool<Node>::str() const {
+	std::ostringstream answer;
+	answer << "NodePool(slabs=" << slabCount << ",capacity=" << slotCount
+	       << ",slabUsed=" << slabUsed << "/" << slabLength << ",nextSlabLength=" << nextSlabLength << ")";
+	return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class Node>
+void* NodePool<Node>::allocate() {
+	if(freeList != nullptr) {
+		Slot* slot = freeList;
+		freeList = freeList->next;
+		if(freeList == nullptr) freeTail = nullptr;
+		return slot;
+	}
+	if(slabUsed == slabLength) addSlab();
+	return &slabs[slabUsed++];
+}
+
+
+template<class Node>
+void NodePool<Node>::deallocate(void* node) {
+	Slot* slot = static_cast<Slot*>(node);
+	slot->next = freeList;
+	if(freeList == nullptr) freeTail = slot;
+	freeList = slot;
+}
+
+
+template<class Node>
+void NodePool<Node>::release() {
+	while(slabs != nullptr) {
+		Slot* toDelete = slabs;
+		slabs = slabs[0].next;
+		delete[] toDelete;
+	}
+	oldestSlab = freeList = freeTail = nullptr;
+	slabUsed = slabLength = 0;
+	slabCount = slotCount = 0;
+}
+
+
+template<class Node>
+void NodePool<Node>::adopt(NodePool<Node>& other) {
+	if(this == &other || other.slabs == nullptr) return;
+
+	//Only one slab is bumped, so the rest of other's current slab goes on the free list.
+	//  Then append other's slab chain behind our oldest slab (so our current slab keeps bumping)
+	while(other.slabUsed < other.slabLength)
+		other.deallocate(&other.slabs[other.slabUsed++]);
+	if(slabs == nullptr) {
+		slabs = other.slabs;
+		slabUsed = other.slabUsed;
+		slabLength = other.slabLength;
+	} else
+		oldestSlab[0].next = other.slabs;
+	oldestSlab = other.oldestSlab;
+
+	if(other.freeList != nullptr) {
+		other.freeTail->next = freeList;
+		if(freeList == nullptr) freeTail = other.freeTail;
+		freeList = other.freeList;
+	}
+
+	slabCount += other.slabCount;
+	slotCount += other.slotCount;
+	other.slabs = other.oldestSlab = other.freeList = other.freeTail = nullptr;
+	other.slabUsed = other.slabLength = 0;
+	other.slabCount = other.slotCount = 0;
+	//a queue emptied by merge every epoch would otherwise get a MAX_SLAB_LENGTH slab each time
+	other.nextSlabLength = other.initialSlabLength;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class Node>
+void NodePool<Node>::addSlab() {
+	Slot* slab = new Slot[nextSlabLength + 1];
+	slab[0].next = slabs;
+	if(slabs == nullptr) oldestSlab = slab;
+	slabs = slab;
+	slabUsed = 1;
+	slabLength = nextSlabLength + 1;
+	++slabCount;
+	slotCount += nextSlabLength;
+	if(nextSlabLength < MAX_SLAB_LENGTH)
+		nextSlabLength = nextSlabLength*2 < MAX_SLAB_LENGTH ? nextSlabLength*2 : MAX_SLAB_LENGTH;
+}
+
+}
+
+#endif /* NODE_POOL_HPP_ */
@@ -0,0 +1,69 @@
+#ifndef QUEUE_STATS_HPP_
+#define QUEUE_STATS_HPP_
+
+#include <string>
+#include <sstream>
+
+
+namespace ics {
+
+
+//Operation counts kept by FibPriorityQueue; see its stats()/reset_stats().
+//Compiling with -DICS_QUEUE_STATS makes queue_stats true, so the counts are kept. By default it
+//  is false: the optimizer removes every count and stats() stays all 0.
+//Counting is not thread-safe: when enabled, even const operations (which compare) update the
+//  counts. Every translation unit of a program must be compiled the same way.
+#ifdef ICS_QUEUE_STATS
+const bool queue_stats = true;
+#else
+const bool queue_stats = false;
+#endif
+
+
+struct FibQueueStats {
+	long long consolidations	= 0;	//consolidateRank calls that had a root list to consolidate
+	long long roots				= 0;	//Sum of the root-list lengths they started with
+	long long maxRoots			= 0;	//Longest root list consolidated
+	long long links				= 0;	//Trees linked under another root while consolidating
+	int		  maxDegree			= 0;	//Highest degree (rank) formed by a consolidation
+	long long cuts				= 0;	//Nodes cut to the root list (increase_priority, erase)
+	long long cascadingCuts		= 0;	//Those cuts of marked ancestors (beyond the first per cut)
+	int		  maxCutDepth		= 0;	//Most nodes cut by one cascade
+	long long comparisons		= 0;	//Calls of gt
+	long long allocations		= 0;	//Nodes allocated (enqueue, copy)
+	long long frees				= 0;	//Nodes destroyed (dequeue, erase, clear, destructor)
+
+	void reset() { *this = FibQueueStats(); }
+
+	std::string str() const {
+		std::ostringstream answer;
+		answer << "FibQueueStats(consolidations=" << consolidations << ",roots=" << roots << ",maxRoots=" << maxRoots
+		       << ",links=" << links << ",maxDegree=" << maxDegree << ",cuts=" << cuts << ",cascadingCuts=" << cascadingCuts
+		       << ",maxCutDepth=" << maxCutDepth << ",comparisons=" << comparisons
+		       << ",allocations=" << allocations << ",frees=" << frees << ")";
+		return answer.str();
+	}
+};
+
+
+//Holds the statistics of a queue that derives from it. With queue_stats false it is empty (the
+//  empty-base optimization removes it): statistics then names one shared FibQueueStats that is
+//  never updated, so the counting code still compiles (and is removed) and stats() stays all 0.
+template<bool kept = queue_stats, class Unused = void>
+class FibQueueStatsStorage {
+	protected:
+		mutable FibQueueStats statistics;
+};
+
+template<class Unused>
+class FibQueueStatsStorage<false,Unused> {
+	protected:
+		static FibQueueStats statistics;
+};
+
+template<class Unused>
+FibQueueStats FibQueueStatsStorage<false,Unused>::statistics;
+
+}
+
+#endif /* QUEUE_STATS_HPP_ */
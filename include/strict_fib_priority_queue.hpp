@@ -0,0 +1,1516 @@
+#ifndef STRICT_FIB_PRIORITY_QUEUE_HPP_
+#define STRICT_FIB_PRIORITY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include <utility>
+#include <vector>					//Iterator frontier (and the nodes an erase reparents)
+#include <algorithm>				//std::push_heap/pop_heap on the frontier
+#include <atomic>					//See newSequence
+#include <new>						//For placement new into pool storage
+#include "courselib/ics_exceptions.hpp"
+#include "iterator_checks.hpp"
+#include "array_stack.hpp"			//See operator <<
+#include "node_pool.hpp"
+#include "gt_policy.hpp"
+namespace ics {
+
+
+//Circular doubly-linked list threaded through N's prev and next members: head is the front
+//  (nullptr if the list is empty) and head->*prev the back. Every operation is O(1)
+template<class N, N* N::*prev, N* N::*next>
+class CircularList {
+	public:
+		static void push_back(N*& head, N* x) {
+			if (head == nullptr) {
+				x->*prev = x->*next = x;
+				head = x;
+			} else {
+				N* back = head->*prev;
+				x->*prev = back;
+				x->*next = head;
+				back->*next = x;
+				head->*prev = x;
+			}
+		}
+
+		static void push_front(N*& head, N* x) {
+			push_back(head, x);
+			head = x;
+		}
+
+		static void insert_after(N* a, N* x) {
+			N* after = a->*next;
+			x->*prev = a;
+			x->*next = after;
+			a->*next = x;
+			after->*prev = x;
+		}
+
+		static void remove(N*& head, N* x) {
+			if (x->*next == x) {
+				head = nullptr;
+				return;
+			}
+			(x->*prev)->*next = x->*next;
+			(x->*next)->*prev = x->*prev;
+			if (head == x)
+				head = x->*next;
+		}
+
+		//a's nodes, then b's
+		static N* concatenate(N* a, N* b) {
+			if (a == nullptr) return b;
+			if (b == nullptr) return a;
+			N* aBack = a->*prev;
+			N* bBack = b->*prev;
+			aBack->*next = b;
+			b->*prev = aBack;
+			bBack->*next = a;
+			a->*prev = bBack;
+			return a;
+		}
+};
+
+
+//A priority queue with FibPriorityQueue's interface whose bounds are all worst-case, not
+//  amortized: a strict Fibonacci heap (Brodal, Lagogiannis and Tarjan) with handles. enqueue,
+//  merge, increase_priority and peek are O(1); dequeue and erase are O(log n). Every call does
+//  a bounded number of restructuring steps, so no single call pays for earlier ones.
+//gt is supplied as for FibPriorityQueue: tgt, cgt, or a Compare type (see gt_policy.hpp).
+//Values live in entries that handles refer to; erase and increase_priority swap entries
+//  between nodes. Equal values are ordered by a sequence number, so the order is total.
+//There is no shared Pool and no peek_k/dequeue_n/drain_while or stats.
+template<class T, bool (*tgt)(const T& a, const T& b) = nullptr, class Compare = void>
+class StrictFibPriorityQueue : private GtPolicy<T,tgt,Compare> {
+	public:
+		//Destructor/Constructors
+		~StrictFibPriorityQueue();
+
+		StrictFibPriorityQueue(bool (*cgt)(const T& a, const T& b) = nullptr);
+		StrictFibPriorityQueue(const StrictFibPriorityQueue<T,tgt,Compare>& to_copy, bool (*cgt)(const T& a, const T& b) = nullptr);
+		StrictFibPriorityQueue(StrictFibPriorityQueue<T,tgt,Compare>&& to_move);	//to_move is left empty
+		explicit StrictFibPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = nullptr);
+		explicit StrictFibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare);	//Compare != void only
+
+		//Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+		template <class Iterable>
+		explicit StrictFibPriorityQueue (const Iterable& i, bool (*cgt)(const T& a, const T& b) = nullptr);
+
+
+		//Queries
+		bool empty		() const;
+		int	size		() const;
+		T&	peek		() const;
+		bool try_peek	(T*& top) const;	//if empty, false (top unchanged); else top = &peek(), true
+		std::string str	() const; //supplies useful debugging information; contrast to operator <<
+
+		//Calls f(const T&) once per element, in no particular order: O(n), no allocation.
+		//f must not modify the queue
+		template <class Function>
+		void for_each	(Function f) const;
+
+
+		//Commands
+		class Handle;
+		int	enqueue	(const T& element);
+		int	enqueue	(T&& element);
+		int	enqueue	(const T& element, Handle& handle);	//handle refers to element until it leaves the queue
+		int	enqueue	(T&& element, Handle& handle);
+		template <class... Args>
+		int emplace	(Args&&... args);					//constructs the element in place from args
+		T dequeue	();									//moves the value out of the queue
+		bool try_dequeue(T& top);						//if empty, false (top unchanged); else moves it to top, true
+		void clear	();
+
+		//handle must refer to an element still in this queue
+		int increase_priority	(const Handle& handle, const T& newValue);	//0 (no change) if newValue has lower priority
+		int increase_priority	(const Handle& handle, T&& newValue);
+		T	erase				(const Handle& handle);
+
+		//Move every element of q2 into this queue, leaving q2 empty; q2 must use the same gt.
+		//O(1): one root becomes a child of the other, and the smaller queue's active nodes all
+		//  become passive at once; q2's pools are adopted (see NodePool::adopt, bounded by
+		//  MAX_SLAB_LENGTH), and handles into q2 then refer into this queue
+		int merge	(StrictFibPriorityQueue<T,tgt,Compare>& q2);
+		int meld	(StrictFibPriorityQueue<T,tgt,Compare>&& q2);
+
+		//Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+		template <class Iterable>
+		int enqueue_all (const Iterable& i);
+
+
+		//Operators
+		StrictFibPriorityQueue<T,tgt,Compare>& operator = (const StrictFibPriorityQueue<T,tgt,Compare>& rhs);
+		StrictFibPriorityQueue<T,tgt,Compare>& operator = (StrictFibPriorityQueue<T,tgt,Compare>&& rhs);
+		bool operator == (const StrictFibPriorityQueue<T,tgt,Compare>& rhs) const;
+		bool operator != (const StrictFibPriorityQueue<T,tgt,Compare>& rhs) const;
+
+		template<class T2, bool (*gt2)(const T2& a, const T2& b), class Compare2>
+		friend std::ostream& operator << (std::ostream& outs, const StrictFibPriorityQueue<T2,gt2,Compare2>& pq);
+
+	private:
+		class HN;	//Defined below; Iterator walks the heap nodes in place
+		class Entry;
+
+	public:
+		class Iterator {
+			public:
+				//Private constructor called in begin/end, which are friends of StrictFibPriorityQueue<T,tgt,Compare>
+				~Iterator();
+				T			erase();
+				std::string str	() const;
+				StrictFibPriorityQueue<T,tgt,Compare>::Iterator& operator ++ ();
+				StrictFibPriorityQueue<T,tgt,Compare>::Iterator	operator ++ (int);
+				bool operator == (const StrictFibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
+				bool operator != (const StrictFibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const;
+				T& operator *	() const;
+				T* operator -> () const;
+				friend std::ostream& operator << (std::ostream& outs, const StrictFibPriorityQueue<T,tgt,Compare>::Iterator& i) {
+					outs << i.str(); //Use the same meaning as the debugging .str() method
+					return outs;
+				}
+
+				friend Iterator StrictFibPriorityQueue<T,tgt,Compare>::begin () const;
+				friend Iterator StrictFibPriorityQueue<T,tgt,Compare>::end   () const;
+
+			private:
+				//Orders the frontier as a binary heap with the highest priority node at front()
+				class FrontierOrder {
+					public:
+						FrontierOrder(StrictFibPriorityQueue<T,tgt,Compare>* pq) : pq(pq) {}
+						bool operator () (HN* a, HN* b) const { return pq->before(b->entry, a->entry); }
+					private:
+						StrictFibPriorityQueue<T,tgt,Compare>* pq;
+				};
+
+				//The frontier holds the root and the children of every node already iterated past;
+				//  its front() is the current node. Erasing moves the erased entry to the root (whose
+				//  entry was passed) and restructures: every node reparented meanwhile is pushed
+				//  again if its entry is not passed yet, and advance drops the extra copies.
+				//  If canErase is false, the current node has been erased and front() already is
+				//  the "next" node (++ does nothing)
+				std::vector<HN*>			frontier;
+				StrictFibPriorityQueue<T,tgt,Compare>* 	refPQ;
+				const Entry*				passed = nullptr;	//Last entry iterated past
+				int							remaining;	//Nodes not yet iterated past (0 at end)
+				int							expectedModCount;
+				bool						canErase = true;
+
+				//Called in friends begin/end
+				Iterator(StrictFibPriorityQueue<T,tgt,Compare>* iterateOver, int remaining);		// nodeCount: begin; 0: end
+
+				void popCurrent();	//Pops front() and any copies of it
+				void advance();		//Replaces front() by its children
+		};
+
+
+		Iterator begin	() const;
+		Iterator end	() const;
+
+	private:
+		//An element: handles refer to it, and it moves between nodes (see increase_priority)
+		class Entry {
+			public:
+				template <class... Args>
+				Entry(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+				T value;
+				HN* node;
+				unsigned long long sequence;				//Breaks ties between equal values
+		};
+
+		//Shared by every active node of one queue: merge makes a queue's active nodes passive by
+		//  clearing its flag. Nodes still pointing to a cleared flag are passive, and drop it
+		//  (and their rank) when they are activated again or deleted
+		class ActiveFlag {
+			public:
+				bool active = true;
+				int refs	= 1;							//The queue's, plus one per node pointing here
+		};
+
+		class RankRecord;
+		enum FixList {NOT_FIXED, ACTIVE_ROOT, LOSS_ONE, BIG_LOSS};
+
+		//A node of the single heap-ordered tree. Every node but the root is active or passive.
+		//  An active node's rank is its number of active children (shared through a RankRecord)
+		//  and its loss counts the active children it lost since it last became active or an
+		//  active root. An active root is an active node with a passive parent.
+		//Children form a circular list with the active ones leftmost (child is the leftmost).
+		//  A passive node is linkable if it has no active children; the root keeps its linkable
+		//  children rightmost (after the non-linkable passive ones), so if it becomes a child in a
+		//  merge its active children are still leftmost. Every non-root node is also on Q
+		class HN {
+			public:
+				HN(Entry* entry) : entry(entry) {}
+
+				Entry* entry;
+				HN* parent			= nullptr;
+				HN* child			= nullptr;
+				HN* left			= this;						//Siblings
+				HN* right			= this;
+				HN* qPrev			= nullptr;
+				HN* qNext			= nullptr;
+				HN* fixPrev			= nullptr;					//On the list fix names
+				HN* fixNext			= nullptr;
+				ActiveFlag* active	= nullptr;
+				RankRecord* rank	= nullptr;
+				int loss			= 0;
+				FixList fix			= NOT_FIXED;
+		};
+
+		//One rank of a queue's active nodes, with the active roots and the loss 1 nodes of that
+		//  rank; ranks with two or more of either are on the queue's rootPairs/lossPairs lists,
+		//  so each reduction finds its nodes in O(1). Ranks are linked through inc/dec
+		class RankRecord {
+			public:
+				RankRecord(int rank, RankRecord* dec) : rank(rank), dec(dec) {}
+
+				int rank;
+				RankRecord* inc					= nullptr;		//Also the next record on the graveyard
+				RankRecord* dec;
+				int refs						= 0;			//Nodes of this rank
+				bool buried						= false;		//Freed when refs reaches 0
+				HN* activeRoots					= nullptr;
+				int activeRootCount				= 0;
+				HN* lossOnes					= nullptr;
+				int lossOneCount				= 0;
+				RankRecord* rootPairPrev		= nullptr;
+				RankRecord* rootPairNext		= nullptr;
+				RankRecord* lossPairPrev		= nullptr;
+				RankRecord* lossPairNext		= nullptr;
+		};
+
+		typedef CircularList<HN,&HN::left,&HN::right>		Siblings;
+		typedef CircularList<HN,&HN::qPrev,&HN::qNext>		QList;
+		typedef CircularList<HN,&HN::fixPrev,&HN::fixNext>	FixMembers;
+		typedef CircularList<RankRecord,&RankRecord::rootPairPrev,&RankRecord::rootPairNext> RootPairs;
+		typedef CircularList<RankRecord,&RankRecord::lossPairPrev,&RankRecord::lossPairNext> LossPairs;
+
+	public:
+		//Stable reference to one enqueued element (see enqueue/increase_priority/erase)
+		class Handle {
+			public:
+				Handle() : entry(nullptr) {}
+				T& operator *	() const { return entry->value; }
+				T* operator ->	() const { return &entry->value; }
+				bool operator == (const Handle& rhs) const { return entry == rhs.entry; }
+				bool operator != (const Handle& rhs) const { return entry != rhs.entry; }
+
+			private:
+				friend class StrictFibPriorityQueue<T,tgt,Compare>;
+				Entry* entry;
+				Handle(Entry* entry) : entry(entry) {}
+		};
+
+	private:
+		typedef GtPolicy<T,tgt,Compare> Gt;					// Supplies this->gt (from template, constructor, or Compare)
+		int nodeCount			= 0;						// The number of nodes in the heap
+		int modCount			= 0;						// For sensing concurrent modification
+		HN* root				= nullptr;					// Holds the highest priority value
+		HN* rootActiveEnd		= nullptr;					// The root's rightmost active child
+		HN* q					= nullptr;					// Q: every non-root node; dequeue works on its front
+		ActiveFlag* activeFlag	= nullptr;
+		RankRecord* rankZero	= nullptr;
+		RankRecord* rankTop		= nullptr;
+		RankRecord* rootPairs	= nullptr;					// Ranks with two or more active roots
+		RankRecord* lossPairs	= nullptr;					// Ranks with two or more loss 1 nodes
+		HN* bigLoss				= nullptr;					// Active nodes with loss 2 or more
+		RankRecord* graveyard	= nullptr;					// Ranks of passive queues, freed a few per call
+		RankRecord* graveyardTail = nullptr;
+		std::vector<HN*>* reparented = nullptr;				// If set, attach records each node it moves
+		NodePool<HN>			heapNodes;					// Storage, released wholesale by clear/destructor
+		NodePool<Entry>			entries;
+		NodePool<RankRecord>	rankRecords;
+		NodePool<ActiveFlag>	activeFlags;
+
+
+		//Helper methods
+		inline bool before(const Entry* a, const Entry* b) const;		//a has higher priority (or is equal and older)
+		static unsigned long long newSequence();						//Unique across queues, so merge keeps ties ordered
+		template <class... Args>
+		inline Entry*	newEntry(Args&&... args);						//Allocation goes through the pools
+		inline HN*		newHeapNode(Entry* entry);
+		inline void		deleteEntry(Entry* toDelete);
+		inline void		deleteHeapNode(HN* toDelete);
+		inline static bool isActive(const HN* heapNode);
+		inline static bool isActiveRoot(const HN* heapNode);
+		inline static bool isLinkable(const HN* heapNode);
+		inline void	attach(HN* heapNode, HN* parent, bool leftmost);	//heapNode must have no parent
+		inline void	attachAfter(HN* heapNode, HN* sibling);
+		inline void	detach(HN* heapNode);
+		inline void	addRootChild(HN* heapNode);							//Placed by whether it is active/linkable
+		inline void	checkLinkable(HN* passiveNode);						//After it lost an active child
+		inline void	lostActiveChild(HN* activeNode);
+		void	unfix(HN* activeNode);									//Off the list its fix names
+		void	refix(HN* activeNode);									//Onto the list its state calls for
+		RankRecord*	rankRecordZero();
+		RankRecord*	rankUp(RankRecord* rank);
+		void	setRank(HN* activeNode, RankRecord* rank);
+		void	releaseRank(RankRecord* rank);
+		void	releaseFlag(ActiveFlag* flag);
+		void	makeActive(HN* passiveNode);
+		void	releaseRecords(HN* heapNode);							//Makes heapNode passive; it must be on no list
+		void	abandon(ActiveFlag* flag, RankRecord* zero, RankRecord* top);	//A melded queue's active nodes become passive
+		void	sweepGraveyard(int count);
+		void	swapStructure(StrictFibPriorityQueue<T,tgt,Compare>& other);	//The heaps (not counts or graveyards)
+		void	forgetStructure();										//Empty, without freeing anything
+		bool	activeRootReduction();
+		bool	rootDegreeReduction();
+		bool	lossReduction();
+		void	meldRoot(HN* otherRoot, HN* otherQ);					//otherRoot's tree becomes part of this heap
+		Entry*	enqueueEntry(Entry* toEnqueue);
+		void	cutToRoot(HN* heapNode);								//heapNode (not the root) becomes a root child
+		void	deleteRoot();											//Its entry is already gone
+		inline void	swapEntries(HN* a, HN* b);
+		template <class V>
+		void	increaseKey(Entry* toIncrease, V&& newValue);
+		T		eraseEntry(Entry* toErase);
+		void	destroyEntries();										//Runs every entry's destructor
+		void	releaseAll();											//destroyEntries, then releases the pools
+
+		template <class Function>
+		void	forEachNode(Function f) const;							//The root, then Q
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//StrictFibPriorityQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::~StrictFibPriorityQueue() {
+	destroyEntries();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "StrictFibPriorityQueue::default constructor");
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(const StrictFibPriorityQueue<T,tgt,Compare>& toCopy, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt, toCopy) {
+	this->check_gt(cgt, "StrictFibPriorityQueue::copy constructor");
+
+	toCopy.for_each([this] (const T& element) { enqueue(element); });
+	modCount = 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(StrictFibPriorityQueue<T,tgt,Compare>&& toMove)
+: Gt(toMove) {
+	heapNodes.adopt(toMove.heapNodes);
+	entries.adopt(toMove.entries);
+	rankRecords.adopt(toMove.rankRecords);
+	activeFlags.adopt(toMove.activeFlags);
+	swapStructure(toMove);
+	nodeCount = toMove.nodeCount;
+	graveyard = toMove.graveyard;
+	graveyardTail = toMove.graveyardTail;
+	toMove.forgetStructure();
+	++toMove.modCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "StrictFibPriorityQueue::initializer_list constructor");
+
+	for(const T& element : il) enqueue(element);
+	modCount = 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(const typename GtPolicy<T,tgt,Compare>::Comparator& compare)
+: Gt(compare) {
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template<class Iterable>
+StrictFibPriorityQueue<T,tgt,Compare>::StrictFibPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
+: Gt(cgt) {
+	this->check_gt(cgt, "StrictFibPriorityQueue::Iterable constructor");
+
+	for(const T& element : i) enqueue(element);
+	modCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::empty() const {
+	return nodeCount == 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::size() const {
+	return nodeCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& StrictFibPriorityQueue<T,tgt,Compare>::peek() const {
+	if(empty()) throw EmptyError("StrictFibPriorityQueue::peek");
+	return root->entry->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::try_peek(T*& top) const {
+	if(empty()) return false;
+	top = &root->entry->value;
+	return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string StrictFibPriorityQueue<T,tgt,Compare>::str() const {
+	std::ostringstream answer;
+	answer << "StrictFibPriorityQueue[";
+	//the root, then its children left to right; active ones are marked with *
+	if(root != nullptr) {
+		answer << root->entry->value << ":{";
+		HN* first = root->child;
+		for(HN* cursor = first; cursor != nullptr; cursor = cursor->right == first ? nullptr : cursor->right)
+			answer << (cursor == first ? "" : ",") << (isActive(cursor) ? "*" : "") << cursor->entry->value;
+		answer << "}";
+	}
+	answer << "](nodeCount=" << nodeCount << ",modCount=" << modCount << ")";
+	return answer.str();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Function>
+void StrictFibPriorityQueue<T,tgt,Compare>::for_each(Function f) const {
+	forEachNode([&f] (HN* heapNode) { f(const_cast<const T&>(heapNode->entry->value)); });
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::enqueue(const T& element) {
+	enqueueEntry(newEntry(element));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::enqueue(T&& element) {
+	enqueueEntry(newEntry(std::move(element)));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::enqueue(const T& element, Handle& handle) {
+	handle = Handle(enqueueEntry(newEntry(element)));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::enqueue(T&& element, Handle& handle) {
+	handle = Handle(enqueueEntry(newEntry(std::move(element))));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class... Args>
+int StrictFibPriorityQueue<T,tgt,Compare>::emplace(Args&&... args) {
+	enqueueEntry(newEntry(std::forward<Args>(args)...));
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T StrictFibPriorityQueue<T,tgt,Compare>::dequeue() {
+	if (this->empty())
+		throw EmptyError("StrictFibPriorityQueue::dequeue");
+
+	T headValue = std::move(root->entry->value);
+	deleteEntry(root->entry);
+	deleteRoot();
+	++modCount;
+	return headValue;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::try_dequeue(T& top) {
+	if(empty()) return false;
+
+	top = std::move(root->entry->value);
+	deleteEntry(root->entry);
+	deleteRoot();
+	++modCount;
+	return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::clear() {
+	releaseAll();
+	forgetStructure();
+	++modCount;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::increase_priority(const Handle& handle, const T& newValue) {
+	if(this->gt(handle.entry->value, newValue)) return 0;
+
+	increaseKey(handle.entry, newValue);
+	++modCount;
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::increase_priority(const Handle& handle, T&& newValue) {
+	if(this->gt(handle.entry->value, newValue)) return 0;
+
+	increaseKey(handle.entry, std::move(newValue));
+	++modCount;
+	return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T StrictFibPriorityQueue<T,tgt,Compare>::erase(const Handle& handle) {
+	return eraseEntry(handle.entry);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::merge(StrictFibPriorityQueue<T,tgt,Compare>& q2) {
+	if(!this->same_gt(q2))
+		throw TemplateFunctionError("StrictFibPriorityQueue::merge: different gt functions");
+	if(this == &q2 || q2.empty()) return 0;
+
+	int count = q2.nodeCount;
+	heapNodes.adopt(q2.heapNodes);
+	entries.adopt(q2.entries);
+	rankRecords.adopt(q2.rankRecords);
+	activeFlags.adopt(q2.activeFlags);
+	if(q2.graveyard != nullptr) {
+		if(graveyard == nullptr)
+			graveyard = q2.graveyard;
+		else
+			graveyardTail->inc = q2.graveyard;
+		graveyardTail = q2.graveyardTail;
+	}
+
+	//this queue keeps the larger heap's active nodes; the smaller heap's become passive
+	if(nodeCount < count)
+		swapStructure(q2);
+	abandon(q2.activeFlag, q2.rankZero, q2.rankTop);
+	if(q2.root != nullptr)
+		meldRoot(q2.root, q2.q);
+	nodeCount += count;
+	++modCount;
+	sweepGraveyard(2);
+
+	q2.forgetStructure();
+	++q2.modCount;
+	return count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+int StrictFibPriorityQueue<T,tgt,Compare>::meld(StrictFibPriorityQueue<T,tgt,Compare>&& q2) {
+	return merge(q2);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Iterable>
+int StrictFibPriorityQueue<T,tgt,Compare>::enqueue_all (const Iterable& i) {
+	int count = 0;
+	for (const T& v : i)
+		count += enqueue(v);
+	return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>& StrictFibPriorityQueue<T,tgt,Compare>::operator = (const StrictFibPriorityQueue<T,tgt,Compare>& rhs) {
+	if(this == &rhs) return *this;
+
+	releaseAll();
+	forgetStructure();
+	this->assign_gt(rhs);
+	rhs.for_each([this] (const T& element) { enqueue(element); });
+	++modCount;
+	return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>& StrictFibPriorityQueue<T,tgt,Compare>::operator = (StrictFibPriorityQueue<T,tgt,Compare>&& rhs) {
+	if(this == &rhs) return *this;
+
+	//release current nodes, then take over rhs's (and its storage)
+	releaseAll();
+	forgetStructure();
+	heapNodes.adopt(rhs.heapNodes);
+	entries.adopt(rhs.entries);
+	rankRecords.adopt(rhs.rankRecords);
+	activeFlags.adopt(rhs.activeFlags);
+
+	this->assign_gt(rhs);
+	swapStructure(rhs);
+	nodeCount = rhs.nodeCount;
+	graveyard = rhs.graveyard;
+	graveyardTail = rhs.graveyardTail;
+	++modCount;
+
+	rhs.forgetStructure();
+	++rhs.modCount;
+	return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::operator == (const StrictFibPriorityQueue<T,tgt,Compare>& rhs) const {
+	if(this == &rhs) return true;
+	if(!this->same_gt(rhs)) return false;
+	if(nodeCount != rhs.nodeCount) return false;
+
+	StrictFibPriorityQueue<T,tgt,Compare>::Iterator left = this->begin(), right = rhs.begin();
+	for(; left != this->end(); ++left, ++right)
+		if (*left != *right)
+			return false;
+	return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::operator != (const StrictFibPriorityQueue<T,tgt,Compare>& rhs) const {
+	return !(*this == rhs);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::ostream& operator << (std::ostream& outs, const StrictFibPriorityQueue<T,tgt,Compare>& p) {
+	outs << "priority_queue[";
+
+	if (!p.empty()) {
+		ArrayStack<T> temp(p);
+		outs << temp.pop();
+		for (int i = 1; i < p.nodeCount; ++i)
+			outs << "," << temp.pop();
+	}
+
+	outs << "]:highest";
+	return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto StrictFibPriorityQueue<T,tgt,Compare>::begin () const -> StrictFibPriorityQueue<T,tgt,Compare>::Iterator {
+	return Iterator(const_cast<StrictFibPriorityQueue<T,tgt,Compare>*>(this), nodeCount);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto StrictFibPriorityQueue<T,tgt,Compare>::end () const -> StrictFibPriorityQueue<T,tgt,Compare>::Iterator {
+	return Iterator(const_cast<StrictFibPriorityQueue<T,tgt,Compare>*>(this), 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline bool StrictFibPriorityQueue<T,tgt,Compare>::before(const Entry* a, const Entry* b) const {
+	if(this->gt(a->value, b->value)) return true;
+	return !this->gt(b->value, a->value) && a->sequence < b->sequence;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+unsigned long long StrictFibPriorityQueue<T,tgt,Compare>::newSequence() {
+	static std::atomic<unsigned long long> nextSequence(0);
+	return nextSequence.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class... Args>
+inline typename StrictFibPriorityQueue<T,tgt,Compare>::Entry* StrictFibPriorityQueue<T,tgt,Compare>::newEntry(Args&&... args) {
+	Entry* entry = new (entries.allocate()) Entry(std::forward<Args>(args)...);
+	entry->sequence = newSequence();
+	return entry;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline typename StrictFibPriorityQueue<T,tgt,Compare>::HN* StrictFibPriorityQueue<T,tgt,Compare>::newHeapNode(Entry* entry) {
+	HN* heapNode = new (heapNodes.allocate()) HN(entry);
+	entry->node = heapNode;
+	return heapNode;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::deleteEntry(Entry* toDelete) {
+	toDelete->~Entry();
+	entries.deallocate(toDelete);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::deleteHeapNode(HN* toDelete) {
+	toDelete->~HN();
+	heapNodes.deallocate(toDelete);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline bool StrictFibPriorityQueue<T,tgt,Compare>::isActive(const HN* heapNode) {
+	return heapNode->active != nullptr && heapNode->active->active;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline bool StrictFibPriorityQueue<T,tgt,Compare>::isActiveRoot(const HN* heapNode) {
+	return isActive(heapNode) && !isActive(heapNode->parent);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline bool StrictFibPriorityQueue<T,tgt,Compare>::isLinkable(const HN* heapNode) {
+	//active children are leftmost
+	return !isActive(heapNode) && (heapNode->child == nullptr || !isActive(heapNode->child));
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::attach(HN* heapNode, HN* parent, bool leftmost) {
+	heapNode->parent = parent;
+	if(leftmost)
+		Siblings::push_front(parent->child, heapNode);
+	else
+		Siblings::push_back(parent->child, heapNode);
+	if(reparented != nullptr)
+		reparented->push_back(heapNode);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::attachAfter(HN* heapNode, HN* sibling) {
+	heapNode->parent = sibling->parent;
+	Siblings::insert_after(sibling, heapNode);
+	if(reparented != nullptr)
+		reparented->push_back(heapNode);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::detach(HN* heapNode) {
+	//the root's active children are leftmost, so the one left of its rightmost is active too
+	if(heapNode == rootActiveEnd)
+		rootActiveEnd = heapNode == root->child ? nullptr : heapNode->left;
+	Siblings::remove(heapNode->parent->child, heapNode);
+	heapNode->parent = nullptr;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::addRootChild(HN* heapNode) {
+	if(isActive(heapNode)) {
+		attach(heapNode, root, true);
+		if(rootActiveEnd == nullptr)
+			rootActiveEnd = heapNode;
+	} else if(isLinkable(heapNode))
+		attach(heapNode, root, false);
+	else if(rootActiveEnd == nullptr)
+		attach(heapNode, root, true);
+	else
+		attachAfter(heapNode, rootActiveEnd);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::checkLinkable(HN* passiveNode) {
+	if(passiveNode->parent == root && isLinkable(passiveNode)) {
+		detach(passiveNode);
+		attach(passiveNode, root, false);
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::lostActiveChild(HN* activeNode) {
+	setRank(activeNode, activeNode->rank->dec);
+	if(!isActiveRoot(activeNode))
+		++activeNode->loss;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::unfix(HN* activeNode) {
+	RankRecord* rank = activeNode->rank;
+	switch(activeNode->fix) {
+		case ACTIVE_ROOT:
+			FixMembers::remove(rank->activeRoots, activeNode);
+			if(rank->activeRootCount-- == 2)
+				RootPairs::remove(rootPairs, rank);
+			break;
+		case LOSS_ONE:
+			FixMembers::remove(rank->lossOnes, activeNode);
+			if(rank->lossOneCount-- == 2)
+				LossPairs::remove(lossPairs, rank);
+			break;
+		case BIG_LOSS:
+			FixMembers::remove(bigLoss, activeNode);
+			break;
+		case NOT_FIXED:
+			break;
+	}
+	activeNode->fix = NOT_FIXED;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::refix(HN* activeNode) {
+	RankRecord* rank = activeNode->rank;
+	if(isActiveRoot(activeNode)) {
+		FixMembers::push_back(rank->activeRoots, activeNode);
+		if(++rank->activeRootCount == 2)
+			RootPairs::push_back(rootPairs, rank);
+		activeNode->fix = ACTIVE_ROOT;
+	} else if(activeNode->loss == 1) {
+		FixMembers::push_back(rank->lossOnes, activeNode);
+		if(++rank->lossOneCount == 2)
+			LossPairs::push_back(lossPairs, rank);
+		activeNode->fix = LOSS_ONE;
+	} else if(activeNode->loss > 1) {
+		FixMembers::push_back(bigLoss, activeNode);
+		activeNode->fix = BIG_LOSS;
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename StrictFibPriorityQueue<T,tgt,Compare>::RankRecord* StrictFibPriorityQueue<T,tgt,Compare>::rankRecordZero() {
+	if(rankZero == nullptr)
+		rankZero = rankTop = new (rankRecords.allocate()) RankRecord(0, nullptr);
+	return rankZero;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename StrictFibPriorityQueue<T,tgt,Compare>::RankRecord* StrictFibPriorityQueue<T,tgt,Compare>::rankUp(RankRecord* rank) {
+	if(rank->inc == nullptr)
+		rank->inc = rankTop = new (rankRecords.allocate()) RankRecord(rank->rank + 1, rank);
+	return rank->inc;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::setRank(HN* activeNode, RankRecord* rank) {
+	++rank->refs;
+	releaseRank(activeNode->rank);
+	activeNode->rank = rank;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::releaseRank(RankRecord* rank) {
+	if(--rank->refs == 0 && rank->buried) {
+		rank->~RankRecord();
+		rankRecords.deallocate(rank);
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::releaseFlag(ActiveFlag* flag) {
+	if(--flag->refs == 0) {
+		flag->~ActiveFlag();
+		activeFlags.deallocate(flag);
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::makeActive(HN* passiveNode) {
+	releaseRecords(passiveNode);
+	if(activeFlag == nullptr)
+		activeFlag = new (activeFlags.allocate()) ActiveFlag();
+	++activeFlag->refs;
+	passiveNode->active = activeFlag;
+	passiveNode->rank = rankRecordZero();
+	++passiveNode->rank->refs;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::releaseRecords(HN* heapNode) {
+	if(heapNode->active != nullptr) {
+		releaseFlag(heapNode->active);
+		heapNode->active = nullptr;
+	}
+	if(heapNode->rank != nullptr) {
+		releaseRank(heapNode->rank);
+		heapNode->rank = nullptr;
+	}
+	heapNode->loss = 0;
+	heapNode->fix = NOT_FIXED;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::abandon(ActiveFlag* flag, RankRecord* zero, RankRecord* top) {
+	if(flag != nullptr) {
+		flag->active = false;
+		releaseFlag(flag);
+	}
+
+	//its nodes may still refer to the ranks, which are freed (later) once they do not
+	if(zero != nullptr) {
+		if(graveyard == nullptr)
+			graveyard = zero;
+		else
+			graveyardTail->inc = zero;
+		graveyardTail = top;
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::sweepGraveyard(int count) {
+	for(; count > 0 && graveyard != nullptr; --count) {
+		RankRecord* rank = graveyard;
+		graveyard = rank->inc;
+		if(graveyard == nullptr)
+			graveyardTail = nullptr;
+		rank->buried = true;
+		if(rank->refs == 0) {
+			rank->~RankRecord();
+			rankRecords.deallocate(rank);
+		}
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::swapStructure(StrictFibPriorityQueue<T,tgt,Compare>& other) {
+	std::swap(root, other.root);
+	std::swap(rootActiveEnd, other.rootActiveEnd);
+	std::swap(q, other.q);
+	std::swap(activeFlag, other.activeFlag);
+	std::swap(rankZero, other.rankZero);
+	std::swap(rankTop, other.rankTop);
+	std::swap(rootPairs, other.rootPairs);
+	std::swap(lossPairs, other.lossPairs);
+	std::swap(bigLoss, other.bigLoss);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::forgetStructure() {
+	nodeCount = 0;
+	root = rootActiveEnd = q = bigLoss = nullptr;
+	activeFlag = nullptr;
+	rankZero = rankTop = rootPairs = lossPairs = graveyard = graveyardTail = nullptr;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::activeRootReduction() {
+	//two active roots of equal rank: the worse one becomes the other's leftmost child
+	if(rootPairs == nullptr) return false;
+
+	HN* x = rootPairs->activeRoots;
+	HN* y = x->fixNext;
+	if(before(y->entry, x->entry))
+		std::swap(x, y);
+	HN* oldParent = y->parent;
+	unfix(x);
+	unfix(y);
+	detach(y);
+	attach(y, x, true);
+	setRank(x, rankUp(x->rank));
+	refix(x);
+	refix(y);
+	checkLinkable(oldParent);
+
+	//x's rightmost child, if passive, moves to the root
+	HN* rightmost = x->child->left;
+	if(!isActive(rightmost)) {
+		detach(rightmost);
+		addRootChild(rightmost);
+	}
+	return true;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::rootDegreeReduction() {
+	//the three rightmost root children, if linkable, become one active root of rank 1: x, with
+	//  y its only active child and z a passive child of y
+	if(root->child == nullptr) return false;
+
+	HN* z = root->child->left;
+	HN* y = z->left;
+	HN* x = y->left;
+	if(y == z || x == z || !isLinkable(x) || !isLinkable(y) || !isLinkable(z)) return false;
+
+	if(before(y->entry, x->entry)) std::swap(x, y);
+	if(before(z->entry, y->entry)) std::swap(y, z);
+	if(before(y->entry, x->entry)) std::swap(x, y);
+	detach(x);
+	detach(y);
+	detach(z);
+	makeActive(x);
+	makeActive(y);
+	attach(z, y, false);
+	attach(y, x, true);
+	setRank(x, rankUp(x->rank));
+	addRootChild(x);
+	refix(x);
+	return true;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::lossReduction() {
+	if(bigLoss != nullptr) {
+		//one node: x (loss 2 or more) becomes an active root
+		HN* x = bigLoss;
+		HN* parent = x->parent;
+		unfix(x);
+		unfix(parent);
+		detach(x);
+		x->loss = 0;
+		addRootChild(x);
+		lostActiveChild(parent);
+		refix(x);
+		refix(parent);
+		return true;
+	}
+
+	if(lossPairs != nullptr) {
+		//two nodes of equal rank and loss 1: the worse one becomes the other's leftmost child
+		HN* x = lossPairs->lossOnes;
+		HN* y = x->fixNext;
+		if(before(y->entry, x->entry))
+			std::swap(x, y);
+		HN* parent = y->parent;
+		unfix(x);
+		unfix(y);
+		if(parent != x)
+			unfix(parent);
+		detach(y);
+		lostActiveChild(parent);
+		attach(y, x, true);
+		setRank(x, rankUp(x->rank));
+		x->loss = y->loss = 0;
+		refix(x);
+		refix(y);
+		if(parent != x)
+			refix(parent);
+		return true;
+	}
+
+	return false;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::meldRoot(HN* otherRoot, HN* otherQ) {
+	//the worse root becomes a child of the better one, and Q becomes otherQ, it, then Q
+	HN* loser = otherRoot;
+	if(before(otherRoot->entry, root->entry)) {
+		loser = root;
+		root = otherRoot;
+		rootActiveEnd = nullptr;		//otherRoot's children are all passive
+	}
+	addRootChild(loser);
+	QList::push_front(q, loser);
+	q = QList::concatenate(otherQ, q);
+
+	activeRootReduction();
+	rootDegreeReduction();
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+typename StrictFibPriorityQueue<T,tgt,Compare>::Entry* StrictFibPriorityQueue<T,tgt,Compare>::enqueueEntry(Entry* toEnqueue) {
+	HN* heapNode = newHeapNode(toEnqueue);
+	if(root == nullptr)
+		root = heapNode;
+	else
+		meldRoot(heapNode, nullptr);
+	sweepGraveyard(2);
+
+	++nodeCount;
+	++modCount;
+	return toEnqueue;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::cutToRoot(HN* heapNode) {
+	HN* parent = heapNode->parent;
+	if(parent == root) return;
+
+	if(!isActive(heapNode)) {
+		detach(heapNode);
+		addRootChild(heapNode);
+		return;
+	}
+
+	//an active node becomes an active root; its parent loses an active child
+	bool parentActive = isActive(parent);
+	unfix(heapNode);
+	if(parentActive)
+		unfix(parent);
+	detach(heapNode);
+	heapNode->loss = 0;
+	addRootChild(heapNode);
+	refix(heapNode);
+	if(parentActive) {
+		lostActiveChild(parent);
+		refix(parent);
+	} else
+		checkLinkable(parent);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::deleteRoot() {
+	HN* oldRoot = root;
+	if(oldRoot->child == nullptr)
+		root = nullptr;
+	else {
+		//the best child becomes the (passive) root, and the other children become its children
+		HN* newRoot = oldRoot->child;
+		for(HN* cursor = newRoot->right; cursor != oldRoot->child; cursor = cursor->right)
+			if(before(cursor->entry, newRoot->entry))
+				newRoot = cursor;
+		Siblings::remove(oldRoot->child, newRoot);
+		QList::remove(q, newRoot);
+		rootActiveEnd = nullptr;
+		if(isActive(newRoot))
+			unfix(newRoot);
+		releaseRecords(newRoot);
+		newRoot->parent = nullptr;
+		root = newRoot;
+
+		//its active children become active roots; every child is placed by its linkability
+		HN* children[2] = {newRoot->child, oldRoot->child};
+		newRoot->child = nullptr;
+		int rootDegree = 0;
+		for(HN* first : children) {
+			if(first == nullptr) continue;
+			HN* last = first->left;
+			for(HN* cursor = first, *next; ; cursor = next) {
+				next = cursor->right;
+				bool active = isActive(cursor);
+				if(active) {
+					unfix(cursor);
+					cursor->loss = 0;
+				}
+				addRootChild(cursor);
+				++rootDegree;
+				if(active)
+					refix(cursor);
+				if(cursor == last) break;
+			}
+		}
+
+		//the first two nodes of Q move to its back, each giving the root up to 2 passive children
+		for(int i = 0; i < 2 && q != nullptr; ++i) {
+			HN* front = q;
+			q = q->qNext;
+			for(int j = 0; j < 2 && front->child != nullptr && !isActive(front->child->left); ++j) {
+				HN* passiveChild = front->child->left;
+				detach(passiveChild);
+				addRootChild(passiveChild);
+				++rootDegree;
+			}
+		}
+
+		//Each loss reduction lowers the total loss by at least 1. That total is at most the number
+		//  of ranks plus 1 (increaseKey adds at most 1 and then reduces; with no reduction
+		//  possible each rank has at most one node of loss 1), so rank + 2 reductions suffice
+		int lossBound = (rankTop == nullptr ? 0 : rankTop->rank) + 2;
+		for(int i = 0; i < lossBound && lossReduction(); ++i)
+			++rootDegree;			//at most one new active root each
+		//Each active root or root degree reduction lowers (active roots + root degree) by at
+		//  least 1, and active roots are root children: 2 * rootDegree reductions suffice
+		for(int i = 0; i < 2 * rootDegree && (activeRootReduction() || rootDegreeReduction()); ++i) {}
+	}
+
+	releaseRecords(oldRoot);
+	deleteHeapNode(oldRoot);
+	--nodeCount;
+	sweepGraveyard(4);
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+inline void StrictFibPriorityQueue<T,tgt,Compare>::swapEntries(HN* a, HN* b) {
+	std::swap(a->entry, b->entry);
+	a->entry->node = a;
+	b->entry->node = b;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class V>
+void StrictFibPriorityQueue<T,tgt,Compare>::increaseKey(Entry* toIncrease, V&& newValue) {
+	toIncrease->value = std::forward<V>(newValue);
+
+	HN* heapNode = toIncrease->node;
+	if(heapNode == root) return;
+
+	//heapNode becomes a root child, taking the root's entry if it now precedes it
+	bool cut = heapNode->parent != root;
+	cutToRoot(heapNode);
+	if(before(toIncrease, root->entry))
+		swapEntries(heapNode, root);
+	if(cut) {
+		lossReduction();
+		for(int i = 0; i < 6 && activeRootReduction(); ++i) {}
+		for(int i = 0; i < 4 && rootDegreeReduction(); ++i) {}
+		sweepGraveyard(2);
+	}
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T StrictFibPriorityQueue<T,tgt,Compare>::eraseEntry(Entry* toErase) {
+	//cut the entry's node to the root and swap their entries (as if its priority were the
+	//  highest), then delete the root
+	HN* heapNode = toErase->node;
+	if(heapNode != root) {
+		cutToRoot(heapNode);
+		swapEntries(heapNode, root);
+	}
+
+	T value = std::move(toErase->value);
+	deleteEntry(toErase);
+	deleteRoot();
+	++modCount;
+	return value;
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::destroyEntries() {
+	forEachNode([] (HN* heapNode) { heapNode->entry->~Entry(); });
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::releaseAll() {
+	destroyEntries();
+	heapNodes.release();
+	entries.release();
+	rankRecords.release();
+	activeFlags.release();
+}
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+template <class Function>
+void StrictFibPriorityQueue<T,tgt,Compare>::forEachNode(Function f) const {
+	//Q holds every node but the root, so no traversal of the (possibly deep) tree is needed
+	if(root == nullptr) return;
+	f(root);
+	if(q == nullptr) return;
+	HN* cursor = q;
+	do {
+		HN* next = cursor->qNext;
+		f(cursor);
+		cursor = next;
+	} while(cursor != q);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::Iterator::Iterator(StrictFibPriorityQueue<T,tgt,Compare>* iterateOver, int remaining)
+: refPQ(iterateOver), remaining(remaining), expectedModCount(iterateOver->modCount) {
+	// Frontier starts as the root; nodes below are reached as their parents are passed.
+	// An end Iterator's frontier stays empty: beyond the last value
+	if (remaining != 0)
+		frontier.push_back(refPQ->root);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+StrictFibPriorityQueue<T,tgt,Compare>::Iterator::~Iterator()
+{}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T StrictFibPriorityQueue<T,tgt,Compare>::Iterator::erase() {
+	if (expectedModCount != refPQ->modCount)
+		throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::erase");
+	if (!canErase)
+		throw CannotEraseError("StrictFibPriorityQueue::Iterator::erase Iterator cursor already erased");
+	if (frontier.empty())
+		throw CannotEraseError("StrictFibPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
+
+	//Before anything is passed the current node is the root: start again from the new root.
+	//  Otherwise the root's entry is passed, so the erased entry's node becomes the root after
+	//  the erase and is freed by the next one: no frontier node is ever freed
+	canErase = false;
+	HN* current = frontier.front();
+	popCurrent();
+	std::vector<HN*> moved;
+	if (passed != nullptr) {
+		for (HN* childNode = current->child; childNode != nullptr; childNode = childNode->right == current->child ? nullptr : childNode->right)
+			moved.push_back(childNode);
+		refPQ->reparented = &moved;
+	}
+	T toReturn = refPQ->eraseEntry(current->entry);
+	refPQ->reparented = nullptr;
+
+	if (passed == nullptr) {
+		if (refPQ->root != nullptr)
+			frontier.push_back(refPQ->root);
+	} else
+		for (HN* heapNode : moved)
+			if (refPQ->before(passed, heapNode->entry)) {
+				frontier.push_back(heapNode);
+				std::push_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
+			}
+	--remaining;
+	expectedModCount = refPQ->modCount;
+	return toReturn;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+std::string StrictFibPriorityQueue<T,tgt,Compare>::Iterator::str() const {
+	std::ostringstream answer;
+	answer << refPQ->str() << "/current=";
+	if (frontier.empty())
+		answer << "end";
+	else
+		answer << frontier.front()->entry->value;
+	answer << "/remaining=" << remaining << "/expectedModCount=" << expectedModCount << "/canErase=" << canErase;
+	return answer.str();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator ++ () -> StrictFibPriorityQueue<T,tgt,Compare>::Iterator& {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
+		throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator ++");
+
+	if (frontier.empty())
+		return *this;
+
+	if (canErase)
+		advance();
+	else
+		canErase = true;
+
+	return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+auto StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator ++ (int) -> StrictFibPriorityQueue<T,tgt,Compare>::Iterator {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
+		throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator ++(int)");
+
+	if (frontier.empty())
+		return *this;
+
+	Iterator toReturn(*this);
+	if (canErase)
+		advance();
+	else
+		canErase = true;
+
+	return toReturn;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator == (const StrictFibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+	if (checked_iterators) {
+		const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+		if (rhsASI == 0)
+			throw IteratorTypeError("StrictFibPriorityQueue::Iterator::operator ==");
+		if (expectedModCount != refPQ->modCount)
+			throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator ==");
+		if (refPQ != rhsASI->refPQ)
+			throw ComparingDifferentIteratorsError("StrictFibPriorityQueue::Iterator::operator ==");
+	}
+
+	//Two iterators on the same heap are equal if the same number of values remain
+	return this->remaining == rhs.remaining;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+bool StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator != (const StrictFibPriorityQueue<T,tgt,Compare>::Iterator& rhs) const {
+	if (checked_iterators) {
+		const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+		if (rhsASI == 0)
+			throw IteratorTypeError("StrictFibPriorityQueue::Iterator::operator !=");
+		if (expectedModCount != refPQ->modCount)
+			throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator !=");
+		if (refPQ != rhsASI->refPQ)
+			throw ComparingDifferentIteratorsError("StrictFibPriorityQueue::Iterator::operator !=");
+	}
+
+	return this->remaining != rhs.remaining;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T& StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator *() const {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
+		throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator *");
+	if (checked_iterators && (!canErase || frontier.empty()))
+		throw IteratorPositionIllegal("StrictFibPriorityQueue::Iterator::operator * Iterator illegal: exhausted");
+
+	return frontier.front()->entry->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+T* StrictFibPriorityQueue<T,tgt,Compare>::Iterator::operator ->() const {
+	if (checked_iterators && expectedModCount != refPQ->modCount)
+		throw ConcurrentModificationError("StrictFibPriorityQueue::Iterator::operator *");
+	if (checked_iterators && (!canErase || frontier.empty()))
+		throw IteratorPositionIllegal("StrictFibPriorityQueue::Iterator::operator -> Iterator illegal: exhausted");
+
+	return &frontier.front()->entry->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::Iterator::popCurrent() {
+	HN* current = frontier.front();
+	//copies of a node have the same entry, so they are adjacent in the (total) order
+	do {
+		std::pop_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
+		frontier.pop_back();
+	} while(!frontier.empty() && frontier.front() == current);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b), class Compare>
+void StrictFibPriorityQueue<T,tgt,Compare>::Iterator::advance() {
+	HN* current = frontier.front();
+	popCurrent();
+
+	HN* first = current->child;
+	for(HN* childNode = first; childNode != nullptr; childNode = childNode->right == first ? nullptr : childNode->right) {
+		frontier.push_back(childNode);
+		std::push_heap(frontier.begin(), frontier.end(), FrontierOrder(refPQ));
+	}
+	passed = current->entry;
+	--remaining;
+}
+
+}
+
+#endif /* STRICT_FIB_PRIORITY_QUEUE_HPP_ */
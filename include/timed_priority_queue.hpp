@@ -0,0 +1,216 @@
+#ifndef TIMED_PRIORITY_QUEUE_HPP_
+#define TIMED_PRIORITY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <utility>
+#include <type_traits>
+#include "latency_histogram.hpp"
+
+
+namespace ics {
+
+
+//Opt-in latency recording for a priority queue PQ (FibPriorityQueue or ArrayPriorityQueue):
+//  a TimedPriorityQueue<PQ> is a PQ whose enqueue, dequeue, peek, clear, begin and Iterator
+//  ++/erase also record their latencies (see latency_clock) in one LatencyHistogram per Op.
+//Everything else (try_dequeue, handles, merge, ...) is PQ's, and is not timed. Each timed call
+//  reads the clock twice; recording is not thread-safe.
+template<class PQ>
+class TimedPriorityQueue : public PQ {
+	public:
+		typedef typename std::remove_reference<decltype(std::declval<PQ&>().peek())>::type T;
+		enum Op {ENQUEUE, DEQUEUE, PEEK, CLEAR, BEGIN, ITERATOR_PLUSPLUS, ITERATOR_ERASE, OP_COUNT};
+
+		using PQ::PQ;
+
+		//Queries
+		T&	peek		() const;
+		const LatencyHistogram& latency(Op op) const { return histograms[op]; }
+		static const char* op_name(Op op);
+
+		//Writes one line of percentiles per Op that was called; write_latencies returns false if
+		//  file_name cannot be opened
+		void print_latencies(std::ostream& outs) const;
+		bool write_latencies(const std::string& file_name) const;
+
+		//Commands
+		using PQ::enqueue;					//Handle overloads (FibPriorityQueue) are not timed
+		int	enqueue	(const T& element);
+		int	enqueue	(T&& element);
+		T	dequeue	();
+		void clear	();
+		void reset_latencies();
+
+
+		class Iterator {
+			public:
+				T			erase();
+				std::string str	() const				{ return i.str(); }
+				Iterator& operator ++ ();
+				Iterator  operator ++ (int)				{ Iterator old(*this); ++*this; return old; }
+				bool operator == (const Iterator& rhs) const	{ return i == rhs.i; }
+				bool operator != (const Iterator& rhs) const	{ return i != rhs.i; }
+				T& operator *	() const				{ return *i; }
+				T* operator ->	() const				{ return &*i; }
+				friend std::ostream& operator << (std::ostream& outs, const Iterator& i) {
+					outs << i.str(); //Use the same meaning as the debugging .str() method
+					return outs;
+				}
+
+			private:
+				friend class TimedPriorityQueue<PQ>;
+				typename PQ::Iterator			i;
+				const TimedPriorityQueue<PQ>*	timedPQ;
+
+				Iterator(const typename PQ::Iterator& i, const TimedPriorityQueue<PQ>* timedPQ) : i(i), timedPQ(timedPQ) {}
+		};
+
+		Iterator begin	() const;
+		Iterator end	() const;
+
+	private:
+		mutable LatencyHistogram histograms[OP_COUNT];
+
+		void record(Op op, long long start) const { histograms[op].record(latency_clock::now() - start); }
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//TimedPriorityQueue class and related definitions
+
+//Queries
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::peek() const -> T& {
+	long long start = latency_clock::now();
+	T& answer = PQ::peek();
+	record(PEEK, start);
+	return answer;
+}
+
+
+template<class PQ>
+const char* TimedPriorityQueue<PQ>::op_name(Op op) {
+	static const char* names[OP_COUNT] = {"enqueue", "dequeue", "peek", "clear", "begin", "iterator++", "iterator.erase"};
+	return names[op];
+}
+
+
+template<class PQ>
+void TimedPriorityQueue<PQ>::print_latencies(std::ostream& outs) const {
+	outs << std::setw(16) << "op" << std::setw(12) << "count" << std::setw(10) << "mean";
+	for(const char* p : {"p50", "p90", "p99", "p99.9", "p99.99", "max"})
+		outs << std::setw(10) << p;
+	outs << "  (" << latency_clock::unit() << ")" << std::endl;
+
+	for(int op = 0; op < OP_COUNT; ++op) {
+		const LatencyHistogram& h = histograms[op];
+		if(h.count() == 0) continue;
+		outs << std::setw(16) << op_name(Op(op)) << std::setw(12) << h.count()
+		     << std::setw(10) << std::fixed << std::setprecision(1) << h.mean();
+		for(double p : {50.0, 90.0, 99.0, 99.9, 99.99})
+			outs << std::setw(10) << h.percentile(p);
+		outs << std::setw(10) << h.max() << std::endl;
+	}
+}
+
+
+template<class PQ>
+bool TimedPriorityQueue<PQ>::write_latencies(const std::string& file_name) const {
+	std::ofstream file(file_name);
+	if(!file) return false;
+	print_latencies(file);
+	return bool(file);
+}
+
+
+//Commands
+
+template<class PQ>
+int TimedPriorityQueue<PQ>::enqueue(const T& element) {
+	long long start = latency_clock::now();
+	int answer = PQ::enqueue(element);
+	record(ENQUEUE, start);
+	return answer;
+}
+
+
+template<class PQ>
+int TimedPriorityQueue<PQ>::enqueue(T&& element) {
+	long long start = latency_clock::now();
+	int answer = PQ::enqueue(std::move(element));
+	record(ENQUEUE, start);
+	return answer;
+}
+
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::dequeue() -> T {
+	long long start = latency_clock::now();
+	T answer = PQ::dequeue();
+	record(DEQUEUE, start);
+	return answer;
+}
+
+
+template<class PQ>
+void TimedPriorityQueue<PQ>::clear() {
+	long long start = latency_clock::now();
+	PQ::clear();
+	record(CLEAR, start);
+}
+
+
+template<class PQ>
+void TimedPriorityQueue<PQ>::reset_latencies() {
+	for(LatencyHistogram& h : histograms)
+		h.reset();
+}
+
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::begin() const -> Iterator {
+	long long start = latency_clock::now();
+	Iterator answer(PQ::begin(), this);
+	record(BEGIN, start);
+	return answer;
+}
+
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::end() const -> Iterator {
+	return Iterator(PQ::end(), this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::Iterator::erase() -> T {
+	long long start = latency_clock::now();
+	T answer = i.erase();
+	timedPQ->record(ITERATOR_ERASE, start);
+	return answer;
+}
+
+
+template<class PQ>
+auto TimedPriorityQueue<PQ>::Iterator::operator ++ () -> Iterator& {
+	long long start = latency_clock::now();
+	++i;
+	timedPQ->record(ITERATOR_PLUSPLUS, start);
+	return *this;
+}
+
+}
+
+#endif /* TIMED_PRIORITY_QUEUE_HPP_ */
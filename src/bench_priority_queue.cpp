@@ -0,0 +1,1029 @@
+//Micro-benchmarks for FibPriorityQueue; build with "make bench" (optimized, no gtest).
+//Usage: bench [section] [size ...]   (default: every section; sizes 100000 1000000 10000000)
+//  section is one of: consolidation comparator large_scale_speed keyed node_storage peek_k
+//  batch poll iterate copy parallel stats latency incremental worst_case suite
+//All values are generated from a fixed seed, so runs are comparable.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <queue>                     //std::priority_queue: see bench suite
+#include <fstream>
+#include "array_stack.hpp"
+#include "array_queue.hpp"
+#include "array_set.hpp"
+#include "array_priority_queue.hpp"
+#include "fib_priority_queue.hpp"
+#include "keyed_fib_priority_queue.hpp"
+#include "compact_fib_priority_queue.hpp"
+#include "strict_fib_priority_queue.hpp"
+#include "timed_priority_queue.hpp"
+
+
+bool gt_int    (const int& a, const int& b) {return a < b;}
+bool gt_double (const double& a, const double& b) {return a < b;}
+bool gt_llong  (const long long& a, const long long& b) {return a < b;}
+bool gt_string (const std::string& a, const std::string& b) {return a < b;}
+
+typedef ics::FibPriorityQueue<int,gt_int> PriorityQueueTypeInt;
+typedef std::chrono::steady_clock         Clock;
+
+volatile double sink;                     //Results are stored here so they are not optimized away
+
+
+//Every allocation is counted, to report bytes per element; each block carries its size.
+//The counts are atomic, since the parallel section allocates from several threads
+std::atomic<std::size_t> live_bytes(0);
+std::atomic<std::size_t> peak_bytes(0);
+
+void* operator new (std::size_t size) {
+  std::size_t* block = static_cast<std::size_t*>(std::malloc(size + 16));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  block[0] = size;
+  std::size_t live = live_bytes += size;
+  if (live > peak_bytes)
+    peak_bytes = live;
+  return reinterpret_cast<char*>(block) + 16;
+}
+
+void operator delete (void* p) noexcept {
+  if (p == nullptr)
+    return;
+  std::size_t* block = reinterpret_cast<std::size_t*>(reinterpret_cast<std::uintptr_t>(p) - 16);
+  live_bytes -= block[0];
+  std::free(block);
+}
+
+
+void reset_peak() {
+  peak_bytes = live_bytes.load();
+}
+
+
+double elapsed_ns(Clock::time_point start) {
+  return std::chrono::duration<double,std::nano>(Clock::now()-start).count();
+}
+
+
+std::vector<int> shuffled_values(int size) {
+  std::vector<int> values;
+  for (int i=0; i<size; ++i)
+    values.push_back(i);
+  std::shuffle(values.begin(),values.end(),std::mt19937(12345));
+  return values;
+}
+
+
+//The first dequeue after n enqueues links n singleton roots; every later dequeue
+//  consolidates the O(log n) roots left behind plus the promoted children
+void bench_consolidation(const std::vector<int>& sizes) {
+  std::cout << "consolidateRank" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(16) << "first dequeue" << std::setw(14) << "ns/root"
+            << std::setw(18) << "dequeue ns/op" << std::setw(10) << "log2(n)" << std::endl;
+
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    PriorityQueueTypeInt q;
+    for (int v : values)
+      q.enqueue(v);
+
+    Clock::time_point start = Clock::now();
+    double checksum = q.dequeue();
+    double first = elapsed_ns(start);
+
+    start = Clock::now();
+    while (!q.empty())
+      checksum += q.dequeue();
+    double rest = elapsed_ns(start);
+    sink = checksum;
+
+    std::cout << std::setw(10) << n
+              << std::setw(13) << std::fixed << std::setprecision(2) << first/1e6 << " ms"
+              << std::setw(14) << std::setprecision(1) << first/n
+              << std::setw(18) << rest/(n > 1 ? n-1 : 1)
+              << std::setw(10) << std::log2(n) << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//ns per (enqueue + dequeue) pair for n shuffled values
+template<class PQ, class V>
+double enqueue_dequeue_ns(PQ& q, const std::vector<V>& values) {
+  Clock::time_point start = Clock::now();
+  for (const V& v : values)
+    q.enqueue(v);
+  double checksum = 0;
+  while (!q.empty())
+    checksum += q.dequeue();
+  sink = checksum;
+  return elapsed_ns(start)/values.size();
+}
+
+
+//Same queue, gt supplied three ways: runtime pointer (cgt), template pointer (tgt), Compare type
+template<class V, bool (*gt)(const V& a, const V& b)>
+void bench_comparator_row(const char* type, const std::vector<int>& ints) {
+  std::vector<V> values(ints.begin(),ints.end());
+  ics::FibPriorityQueue<V>                       q_cgt(gt);
+  ics::FibPriorityQueue<V,gt>                    q_tgt;
+  ics::FibPriorityQueue<V,nullptr,std::less<V>>  q_compare;
+  std::cout << std::setw(8) << type << std::setw(10) << values.size() << std::fixed << std::setprecision(1)
+            << std::setw(12) << enqueue_dequeue_ns(q_cgt,values)
+            << std::setw(12) << enqueue_dequeue_ns(q_tgt,values)
+            << std::setw(12) << enqueue_dequeue_ns(q_compare,values) << std::endl;
+}
+
+
+void bench_comparator(const std::vector<int>& sizes) {
+  std::cout << "gt dispatch (ns per enqueue+dequeue)" << std::endl;
+  std::cout << std::setw(8) << "type" << std::setw(10) << "n" << std::setw(12) << "cgt"
+            << std::setw(12) << "tgt" << std::setw(12) << "Compare" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    bench_comparator_row<int,gt_int>      ("int",   values);
+    bench_comparator_row<double,gt_double>("double",values);
+  }
+  std::cout << std::endl;
+}
+
+
+//The large_scale_speed test's workload: random-sized enqueue/dequeue batches, each followed
+//  by a full iteration; reported per value enqueued (and dequeued), best of 3 runs
+template<class V, bool (*gt)(const V& a, const V& b)>
+double large_scale_speed_ns(const std::vector<int>& ints) {
+  std::vector<V> values(ints.begin(),ints.end());
+  int n = values.size();
+  double best = 0;
+  for (int run=0; run<3; ++run) {
+    std::mt19937 random(12345);
+    ics::FibPriorityQueue<V,gt> q;
+    double checksum = 0;
+
+    Clock::time_point start = Clock::now();
+    int enqueued = 0;
+    int dequeued = 0;
+    while (dequeued != n) {
+      int to_enqueue = std::uniform_int_distribution<int>(0,n-enqueued)(random);
+      for (int i=0; i <to_enqueue; ++i)
+        q.enqueue(values[enqueued++]);
+      for (const V& v : q)
+        checksum += v;
+      int to_dequeue = std::uniform_int_distribution<int>(0,enqueued-dequeued)(random);
+      for (int i=0; i <to_dequeue; ++i) {
+        checksum += q.dequeue();
+        ++dequeued;
+      }
+      for (const V& v : q)
+        checksum += v;
+    }
+    double ns = elapsed_ns(start)/n;
+    sink = checksum;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+
+void bench_large_scale_speed(const std::vector<int>& sizes) {
+  std::cout << "large_scale_speed workload (ns per value)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "int" << std::setw(12) << "double" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << large_scale_speed_ns<int,gt_int>(values)
+              << std::setw(12) << large_scale_speed_ns<double,gt_double>(values) << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//A scheduler task: the priority is 4 bytes of a 128 byte struct
+struct Task {
+  int  priority;
+  char payload[124];
+};
+bool gt_task (const Task& a, const Task& b) {return a.priority < b.priority;}
+
+
+void bench_keyed(const std::vector<int>& sizes) {
+  std::cout << "key/payload split (ns per enqueue+dequeue of 128 byte tasks)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "whole" << std::setw(12) << "keyed" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> priorities = shuffled_values(n);
+    std::vector<Task> tasks(n);
+    for (int i=0; i<n; ++i)
+      tasks[i].priority = priorities[i];
+
+    ics::FibPriorityQueue<Task,gt_task> whole;
+    Clock::time_point start = Clock::now();
+    for (const Task& t : tasks)
+      whole.enqueue(t);
+    double checksum = 0;
+    while (!whole.empty())
+      checksum += whole.dequeue().priority;
+    double whole_ns = elapsed_ns(start)/n;
+
+    ics::KeyedFibPriorityQueue<int,Task,gt_int> keyed;
+    start = Clock::now();
+    for (const Task& t : tasks)
+      keyed.enqueue(t.priority,t);
+    while (!keyed.empty())
+      checksum += keyed.dequeue().first;
+    double keyed_ns = elapsed_ns(start)/n;
+    sink = checksum;
+
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << whole_ns << std::setw(12) << keyed_ns << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Peak heap bytes per element (above before) while holding n values, and ns per enqueue+dequeue
+template<class PQ>
+void node_storage_row(const char* name, PQ& q, const std::vector<int>& values, std::size_t before) {
+  reset_peak();
+  Clock::time_point start = Clock::now();
+  for (int v : values)
+    q.enqueue(v);
+  double checksum = q.dequeue();              //links the n roots
+  double bytes = double(peak_bytes - before)/values.size();
+  while (!q.empty())
+    checksum += q.dequeue();
+  sink = checksum;
+  std::cout << std::setw(10) << name << std::setw(10) << values.size() << std::fixed << std::setprecision(1)
+            << std::setw(14) << bytes << std::setw(12) << elapsed_ns(start)/values.size() << std::endl;
+}
+
+
+void bench_node_storage(const std::vector<int>& sizes) {
+  std::cout << "node storage (int keys)" << std::endl;
+  std::cout << std::setw(10) << "queue" << std::setw(10) << "n" << std::setw(14) << "peak B/elem"
+            << std::setw(12) << "ns/op" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    {
+      PriorityQueueTypeInt q;
+      node_storage_row("pointers",q,values,live_bytes);
+    }
+    {
+      ics::CompactFibPriorityQueue<int,gt_int> q;
+      node_storage_row("indices",q,values,live_bytes);     //peak includes the vector's regrowth
+    }
+    {
+      std::size_t before = live_bytes;
+      ics::CompactFibPriorityQueue<int,gt_int> q;
+      q.reserve(n);
+      node_storage_row("reserved",q,values,before);
+    }
+  }
+  std::cout << std::endl;
+}
+
+
+//Top 100 of n consolidated values: peek_k against the first 100 steps of an Iterator
+void bench_peek_k(const std::vector<int>& sizes) {
+  const int k = 100;
+  std::cout << "top " << k << " (us per query)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "peek_k" << std::setw(12) << "Iterator" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    PriorityQueueTypeInt q;
+    q.enqueue_all(values);
+    q.dequeue();
+    std::vector<int> top;
+    top.reserve(k);
+    const int queries = 1000;
+
+    Clock::time_point start = Clock::now();
+    double checksum = 0;
+    for (int i=0; i<queries; ++i) {
+      top.clear();
+      q.peek_k(k,std::back_inserter(top));
+      checksum += top.back();
+    }
+    double peek_k_us = elapsed_ns(start)/queries/1000;
+
+    start = Clock::now();
+    for (int i=0; i<queries; ++i) {
+      int taken = 0;
+      for (PriorityQueueTypeInt::Iterator it = q.begin(); taken < k; ++it, ++taken)
+        checksum += *it;
+    }
+    double iterator_us = elapsed_ns(start)/queries/1000;
+    sink = checksum;
+
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(2)
+              << std::setw(12) << peek_k_us << std::setw(12) << iterator_us << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//A consumer holding n values that repeatedly takes a batch of 256 and receives 256 more
+//  (ns per value, best of 3): 256 dequeue calls against one dequeue_n
+void bench_batch(const std::vector<int>& sizes) {
+  const int batch = 256;
+  std::cout << "batched dequeue, " << batch << " per wakeup (ns per value)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "dequeue" << std::setw(12) << "dequeue_n" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    std::vector<int> out(batch);
+    double checksum = 0;
+    double ns[2];
+    for (int run=0; run<6; ++run) {
+      int mode = run%2;
+      PriorityQueueTypeInt q;
+      q.enqueue_all(values);
+      q.dequeue();
+      std::mt19937 random(12345);
+      int rounds = std::max(1, 2*n/batch);
+      Clock::time_point start = Clock::now();
+      for (int r=0; r<rounds; ++r) {
+        if (mode == 0)
+          for (int i=0; i<batch; ++i)
+            out[i] = q.dequeue();
+        else
+          q.dequeue_n(batch,out.begin());
+        checksum += out[batch-1];
+        for (int i=0; i<batch; ++i)
+          q.enqueue(out[i] + std::uniform_int_distribution<int>(0,n)(random));
+      }
+      double run_ns = elapsed_ns(start)/rounds/batch;
+      if (run < 2 || run_ns < ns[mode])
+        ns[mode] = run_ns;
+    }
+    sink = checksum;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << ns[0] << std::setw(12) << ns[1] << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Bursty polling: n rounds, each enqueueing 0 or 2 values (at random) then polling twice, so
+//  half the polls find the queue empty; ns per poll with try/catch around dequeue vs try_dequeue
+void bench_poll(const std::vector<int>& sizes) {
+  std::cout << "polling, half empty (ns per poll)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "catch" << std::setw(12) << "try_" << std::endl;
+  for (int n : sizes) {
+    double checksum = 0;
+    double ns[2];
+    for (int mode=0; mode<2; ++mode) {
+      PriorityQueueTypeInt q;
+      std::mt19937 random(12345);
+      Clock::time_point start = Clock::now();
+      for (int r=0; r<n; ++r) {
+        if (random() & 1) {
+          q.enqueue(r);
+          q.enqueue(-r);
+        }
+        for (int i=0; i<2; ++i) {
+          int v;
+          if (mode == 0) {
+            try {
+              v = q.dequeue();
+            } catch (const ics::EmptyError&) {
+              continue;
+            }
+          } else if (!q.try_dequeue(v))
+            continue;
+          checksum += v;
+        }
+      }
+      ns[mode] = elapsed_ns(start)/(2.0*n);
+    }
+    sink = checksum;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << ns[0] << std::setw(12) << ns[1] << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Copy construction of a consolidated queue, a for_each over the copy, its destruction, and
+//  dequeueing every value from a second copy (ns per value, best of 3)
+void bench_copy(const std::vector<int>& sizes) {
+  std::cout << "deep copy (ns per value)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(12) << "copy" << std::setw(12) << "for_each"
+            << std::setw(12) << "destroy" << std::setw(12) << "drain" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    PriorityQueueTypeInt q;
+    q.enqueue_all(values);
+    q.enqueue(-1);
+    q.dequeue();
+    double best[4] = {0,0,0,0};
+    double checksum = 0;
+    for (int run=0; run<3; ++run) {
+      Clock::time_point start = Clock::now();
+      PriorityQueueTypeInt* copy = new PriorityQueueTypeInt(q);
+      double copy_ns = elapsed_ns(start)/n;
+
+      start = Clock::now();
+      copy->for_each([&checksum] (const int& v) {checksum += v;});
+      double for_each_ns = elapsed_ns(start)/n;
+
+      start = Clock::now();
+      delete copy;
+      double destroy_ns = elapsed_ns(start)/n;
+      if (run == 0 || copy_ns < best[0])     best[0] = copy_ns;
+      if (run == 0 || for_each_ns < best[1]) best[1] = for_each_ns;
+      if (run == 0 || destroy_ns < best[2])  best[2] = destroy_ns;
+
+      PriorityQueueTypeInt drained(q);
+      start = Clock::now();
+      while (!drained.empty())
+        checksum += drained.dequeue();
+      double drain_ns = elapsed_ns(start)/n;
+      if (run == 0 || drain_ns < best[3])    best[3] = drain_ns;
+    }
+    sink = checksum;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+              << std::setw(12) << best[0] << std::setw(12) << best[1] << std::setw(12) << best[2]
+              << std::setw(12) << best[3] << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Copy construction and clear of a queue of strings (so every node has a destructor to run)
+//  with set_parallelism(threads), then clear with set_background_release (ms, best of 3)
+void bench_parallel(const std::vector<int>& sizes) {
+  typedef ics::FibPriorityQueue<std::string,gt_string> PriorityQueueTypeStr;
+  int hardware = std::thread::hardware_concurrency();
+  std::vector<int> thread_counts = {1, 2, 4};
+  if (hardware > 4)
+    thread_counts.push_back(hardware);
+  std::cout << "parallel copy/clear of strings (ms; " << hardware << " hardware threads)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(10) << "threads" << std::setw(12) << "copy"
+            << std::setw(12) << "clear" << std::endl;
+  for (int n : sizes) {
+    std::vector<int> values = shuffled_values(n);
+    PriorityQueueTypeStr q;
+    for (int v : values)
+      q.enqueue(std::to_string(v));
+    q.enqueue("");
+    q.dequeue();
+    for (int threads : thread_counts) {
+      q.set_parallelism(threads);
+      double best[2] = {0,0};
+      for (int run=0; run<3; ++run) {
+        Clock::time_point start = Clock::now();
+        PriorityQueueTypeStr copy(q);               //inherits q's parallelism
+        double copy_ms = elapsed_ns(start)/1e6;
+        start = Clock::now();
+        copy.clear();
+        double clear_ms = elapsed_ns(start)/1e6;
+        if (run == 0 || copy_ms < best[0])  best[0] = copy_ms;
+        if (run == 0 || clear_ms < best[1]) best[1] = clear_ms;
+      }
+      std::cout << std::setw(10) << n << std::setw(10) << threads << std::fixed << std::setprecision(2)
+                << std::setw(12) << best[0] << std::setw(12) << best[1] << std::endl;
+    }
+    q.set_parallelism(1);
+    PriorityQueueTypeStr copy(q);
+    copy.set_background_release(true);
+    Clock::time_point start = Clock::now();
+    copy.clear();
+    std::cout << std::setw(10) << n << std::setw(10) << "bg" << std::fixed << std::setprecision(2)
+              << std::setw(12) << "" << std::setw(12) << elapsed_ns(start)/1e6 << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Hold model: n enqueues, then n rounds of increase_priority on a random element, dequeue and
+//  enqueue (a Dijkstra-like mix); prints ns per round and stats() (all 0 unless built with
+//  "make bench_stats"). Each value is key*n+slot, so a dequeued value names its handle's slot
+void bench_stats(const std::vector<int>& sizes) {
+  typedef ics::FibPriorityQueue<long long,gt_llong> PriorityQueueTypeLL;
+  std::cout << "operation counts (" << (ics::queue_stats ? "ICS_QUEUE_STATS" : "not counted") << ")" << std::endl;
+  for (int n : sizes) {
+    std::mt19937 random(12345);
+    std::vector<PriorityQueueTypeLL::Handle> handles(n);
+    PriorityQueueTypeLL q;
+    for (int slot=0; slot<n; ++slot)
+      q.enqueue((long long)(random() % n)*n + slot,handles[slot]);
+    q.reset_stats();
+
+    long long floor = 0;                              //key of the last value dequeued
+    double checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (int round=0; round<n; ++round) {
+      int slot = random() % n;
+      long long key = *handles[slot] / n;
+      if (key > floor)
+        q.increase_priority(handles[slot],(floor + (long long)(random() % (key-floor)))*n + slot);
+      long long v = q.dequeue();
+      checksum += v;
+      floor = v / n;
+      q.enqueue((floor + (long long)(random() % n))*n + v%n,handles[v%n]);
+    }
+    double ns = elapsed_ns(start)/n;
+    sink = checksum;
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(1) << std::setw(10) << ns
+              << " ns/round  " << q.stats().str() << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+
+//Per-operation latency percentiles: bursts of n/10 enqueues, each followed by n/10 rounds of
+//  dequeue+enqueue, then a full iteration, erasing every 100th value, and a clear.
+//  ArrayPriorityQueue (O(n) enqueue) runs at most 100000 values
+template<class PQ>
+void latency_workload(const char* name, int n) {
+  ics::TimedPriorityQueue<PQ> q;
+  std::mt19937 random(12345);
+  int burst = n/10 > 0 ? n/10 : 1;
+  double checksum = 0;
+  while (q.size() < n) {
+    for (int i=0; i<burst; ++i)
+      q.enqueue(random() % n);
+    for (int i=0; i<burst; ++i) {
+      checksum += q.dequeue();
+      q.enqueue(random() % n);
+    }
+  }
+  checksum += q.peek();
+  int position = 0;
+  for (auto i = q.begin(); i != q.end(); ++position)
+    if (position % 100 == 0)
+      checksum += i.erase();
+    else
+      ++i;
+  q.clear();
+  sink = checksum;
+  std::cout << name << ", n = " << n << std::endl;
+  q.print_latencies(std::cout);
+}
+
+
+void bench_latency(const std::vector<int>& sizes) {
+  std::cout << "operation latency percentiles (" << ics::latency_clock::unit() << ")" << std::endl;
+  for (int n : sizes) {
+    latency_workload<PriorityQueueTypeInt>("FibPriorityQueue", n);
+    latency_workload<ics::ArrayPriorityQueue<int,gt_int>>("ArrayPriorityQueue", n < 100000 ? n : 100000);
+  }
+  std::cout << std::endl;
+}
+
+
+//Dequeue latency tail of set_consolidation_budget: after a burst of n enqueues, n/2 rounds of
+//  dequeue then enqueue; full consolidation (budget 0) pays for the whole burst in one dequeue
+void bench_incremental(const std::vector<int>& sizes) {
+  std::cout << "dequeue latency by consolidation budget (" << ics::latency_clock::unit() << ")" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(8) << "budget" << std::setw(10) << "p50" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(12) << "max" << std::setw(12) << "total ms" << std::endl;
+  for (int n : sizes)
+    for (int budget : {0, 4, 16, 64}) {
+      ics::TimedPriorityQueue<PriorityQueueTypeInt> q;
+      q.set_consolidation_budget(budget);
+      std::mt19937 random(12345);
+      double checksum = 0;
+      Clock::time_point start = Clock::now();
+      for (int i=0; i<n; ++i)
+        q.enqueue(random() % n);
+      for (int i=0; i<n/2; ++i) {
+        checksum += q.dequeue();
+        q.enqueue(random() % n);
+      }
+      double total_ms = elapsed_ns(start)/1e6;
+      sink = checksum;
+      const ics::LatencyHistogram& h = q.latency(ics::TimedPriorityQueue<PriorityQueueTypeInt>::DEQUEUE);
+      std::cout << std::setw(10) << n << std::setw(8) << budget << std::setw(10) << h.percentile(50)
+                << std::setw(10) << h.percentile(99) << std::setw(10) << h.percentile(99.9)
+                << std::setw(12) << h.max() << std::setw(12) << std::fixed << std::setprecision(1) << total_ms << std::endl;
+    }
+  std::cout << std::endl;
+}
+
+
+//Latency tails of a control loop with handles: n enqueues, then 2n random rounds of either
+//  dequeue (and enqueue a replacement) or increase_priority of a live element. Values are
+//  key * 2^32 + slot, so a dequeued value names its handle
+template<class PQ>
+void worst_case_workload(const char* name, PQ& q, int n) {
+  std::vector<typename PQ::Handle> handles(n);
+  ics::LatencyHistogram enqueues, dequeues, increases;
+  std::mt19937 random(12345);
+  const long long slot_bits = 1LL << 32;
+  std::vector<long long> values(n);
+  for (int slot=0; slot<n; ++slot) {
+    values[slot] = (long long)(random() % n) * slot_bits + slot;
+    long long start = ics::latency_clock::now();
+    q.enqueue(values[slot],handles[slot]);
+    enqueues.record(ics::latency_clock::now() - start);
+  }
+  for (int round=0; round<2*n; ++round)
+    if (random() % 2 == 0) {
+      long long start = ics::latency_clock::now();
+      long long top = q.dequeue();
+      dequeues.record(ics::latency_clock::now() - start);
+      int slot = int((unsigned long long)top & 0xFFFFFFFF);
+      values[slot] = (long long)(random() % n) * slot_bits + slot;
+      start = ics::latency_clock::now();
+      q.enqueue(values[slot],handles[slot]);
+      enqueues.record(ics::latency_clock::now() - start);
+    } else {
+      int slot = random() % n;
+      values[slot] -= (long long)(random() % n + 1) * slot_bits;
+      long long start = ics::latency_clock::now();
+      q.increase_priority(handles[slot],values[slot]);
+      increases.record(ics::latency_clock::now() - start);
+    }
+  sink = q.peek();
+
+  for (const ics::LatencyHistogram* h : {&enqueues, &dequeues, &increases})
+    std::cout << std::setw(10) << n << std::setw(24) << name
+              << std::setw(12) << (h == &enqueues ? "enqueue" : h == &dequeues ? "dequeue" : "increase")
+              << std::setw(10) << h->percentile(50) << std::setw(10) << h->percentile(99)
+              << std::setw(10) << h->percentile(99.9) << std::setw(12) << h->max() << std::endl;
+}
+
+
+void bench_worst_case(const std::vector<int>& sizes) {
+  std::cout << "latency tails, amortized vs worst-case bounds (" << ics::latency_clock::unit() << ")" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(24) << "queue" << std::setw(12) << "op" << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << std::endl;
+  for (int n : sizes) {
+    {
+      ics::FibPriorityQueue<long long,gt_llong> q;
+      worst_case_workload("FibPQ", q, n);
+    }
+    {
+      ics::FibPriorityQueue<long long,gt_llong> q;
+      q.set_consolidation_budget(16);
+      worst_case_workload("FibPQ budget 16", q, n);
+    }
+    {
+      ics::StrictFibPriorityQueue<long long,gt_llong> q;
+      worst_case_workload("StrictFibPQ", q, n);
+    }
+  }
+  std::cout << std::endl;
+}
+
+
+//std::priority_queue, for the suite: top() is the highest priority value by gt
+template<class T, bool (*gt)(const T& a, const T& b)>
+class StdPriorityQueue {
+  public:
+    bool empty     () const {return q.empty();}
+    int  size      () const {return q.size();}
+    const T& peek  () const {return q.top();}
+    int  enqueue   (const T& element) {q.push(element); return 1;}
+    T    dequeue   () {T top = std::move(const_cast<T&>(q.top())); q.pop(); return top;}
+
+  private:
+    struct Lower {bool operator () (const T& a, const T& b) const {return gt(b,a);}};
+    std::priority_queue<T,std::vector<T>,Lower> q;
+};
+
+
+//KeyedFibPriorityQueue with T keys (and an unused int payload), for the suite
+template<class T, bool (*gt)(const T& a, const T& b)>
+class KeyedQueue {
+  public:
+    typedef typename ics::KeyedFibPriorityQueue<T,int,gt>::Handle Handle;
+    bool empty     () const {return q.empty();}
+    int  size      () const {return q.size();}
+    const T& peek  () const {return q.peek_key();}
+    int  enqueue   (const T& element) {return q.enqueue(element,0);}
+    int  enqueue   (const T& element, Handle& handle) {return q.enqueue(element,0,handle);}
+    T    dequeue   () {return q.dequeue().first;}
+    int  increase_priority(const Handle& handle, const T& key) {return q.increase_priority(handle,key);}
+
+  private:
+    ics::KeyedFibPriorityQueue<T,int,gt> q;
+};
+
+
+//Moves b's elements into a: O(1) where the queue has merge, else one by one
+template<class PQ>
+void meld_into(PQ& a, PQ& b) {
+  while (!b.empty())
+    a.enqueue(b.dequeue());
+}
+
+template<class T, bool (*gt)(const T& a, const T& b), class Compare>
+void meld_into(ics::FibPriorityQueue<T,gt,Compare>& a, ics::FibPriorityQueue<T,gt,Compare>& b) {
+  a.merge(b);
+}
+
+template<class T, bool (*gt)(const T& a, const T& b), class Compare>
+void meld_into(ics::StrictFibPriorityQueue<T,gt,Compare>& a, ics::StrictFibPriorityQueue<T,gt,Compare>& b) {
+  a.merge(b);
+}
+
+
+//The suite's workloads: run times one workload on an empty q of n elements, sets ops to the
+//  queue calls it made, and returns the nanoseconds taken (setup excluded)
+struct Insert {
+  const std::vector<long long>& values;
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<n; ++i)
+      q.enqueue(values[i]);
+    ops = n;
+    return elapsed_ns(start);
+  }
+};
+
+struct InsertDrain {
+  const std::vector<long long>& values;
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    double checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<n; ++i)
+      q.enqueue(values[i]);
+    while (!q.empty())
+      checksum += q.dequeue();
+    ops = 2LL*n;
+    sink = checksum;
+    return elapsed_ns(start);
+  }
+};
+
+//Hold model: a full queue, then n holds of dequeue and enqueue (a later time: the value
+//  dequeued plus a random increment)
+struct Hold {
+  const std::vector<long long>& values;
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    for (int i=0; i<n; ++i)
+      q.enqueue(values[i]);
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<n; ++i)
+      q.enqueue(q.dequeue() + values[(i*7) % n] + 1);
+    ops = 2LL*n;
+    sink = q.peek();
+    return elapsed_ns(start);
+  }
+};
+
+//n enqueues with handles, 2n increase_priority of random elements, then a drain. Queues
+//  without handles (std::priority_queue) enqueue the new value instead and skip stale ones
+//  as they are dequeued (each value is key * 2^32 + slot)
+struct DecreaseKey {
+  const std::vector<long long>& values;
+  static const long long slot_bits = 1LL << 32;
+
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    std::vector<typename PQ::Handle> handles(n);
+    std::vector<long long> current(n);
+    std::mt19937 random(12345);
+    double checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (int slot=0; slot<n; ++slot) {
+      current[slot] = values[slot] * slot_bits + slot;
+      q.enqueue(current[slot],handles[slot]);
+    }
+    for (int i=0; i<2*n; ++i) {
+      int slot = random() % n;
+      current[slot] -= (long long)(random() % n + 1) * slot_bits;
+      q.increase_priority(handles[slot],current[slot]);
+    }
+    while (!q.empty())
+      checksum += q.dequeue();
+    ops = 4LL*n;
+    sink = checksum;
+    return elapsed_ns(start);
+  }
+
+  template<class T, bool (*gt)(const T& a, const T& b)>
+  double run(StdPriorityQueue<T,gt>& q, int n, long long& ops) const {
+    std::vector<long long> current(n);
+    std::mt19937 random(12345);
+    double checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (int slot=0; slot<n; ++slot) {
+      current[slot] = values[slot] * slot_bits + slot;
+      q.enqueue(current[slot]);
+    }
+    for (int i=0; i<2*n; ++i) {
+      int slot = random() % n;
+      current[slot] -= (long long)(random() % n + 1) * slot_bits;
+      q.enqueue(current[slot]);
+    }
+    while (!q.empty()) {
+      long long top = q.dequeue();
+      if (current[(unsigned long long)top & 0xFFFFFFFF] == top)
+        checksum += top;
+    }
+    ops = 4LL*n;
+    sink = checksum;
+    return elapsed_ns(start);
+  }
+};
+
+//n/8 queues of 8 elements, melded pairwise (a tournament) into one; ops counts the melds
+struct Meld {
+  const std::vector<long long>& values;
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    std::vector<PQ> parts(n/8 > 0 ? n/8 : 1);
+    for (int i=0; i<n; ++i)
+      parts[i % parts.size()].enqueue(values[i]);
+    ops = 0;
+    Clock::time_point start = Clock::now();
+    for (std::size_t step=1; step<parts.size(); step*=2)
+      for (std::size_t i=0; i+step<parts.size(); i+=2*step) {
+        meld_into(parts[i],parts[i+step]);
+        ++ops;
+      }
+    meld_into(q,parts[0]);
+    ++ops;
+    double ns = elapsed_ns(start);
+    sink = q.peek();
+    return ns;
+  }
+};
+
+//Words of english3.txt (shuffled) enqueued, then drained
+struct Strings {
+  const std::vector<std::string>& words;
+  template<class PQ>
+  double run(PQ& q, int n, long long& ops) const {
+    double checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<n; ++i)
+      q.enqueue(words[i]);
+    while (!q.empty())
+      checksum += q.dequeue().size();
+    ops = 2LL*n;
+    sink = checksum;
+    return elapsed_ns(start);
+  }
+};
+
+
+//One CSV row; peak_bytes is the most allocated (above what was live before) while q existed
+template<class PQ, class Workload>
+void suite_row(const char* workload, const char* queue, int n, const Workload& w) {
+  std::size_t before = live_bytes;
+  reset_peak();
+  long long ops = 0;
+  double ns;
+  {
+    PQ q;
+    ns = w.run(q, n, ops);
+  }
+  std::cout << workload << "," << queue << "," << n << "," << ops << std::fixed << std::setprecision(2)
+            << "," << ns/ops << "," << ops*1e3/ns << "," << peak_bytes - before << std::endl;
+}
+
+
+//The sorted-array ArrayPriorityQueue enqueues in O(n): its rows use at most this many elements
+const int suite_array_cap = 20000;
+
+//ArrayPriorityQueue has no handles: it has no decrease_key row (handles is std::true_type)
+template<class T, bool (*gt)(const T& a, const T& b), class Workload>
+void suite_array_row(const char* workload, int n, const Workload& w, std::false_type) {
+  suite_row<ics::ArrayPriorityQueue<T,gt>>(workload, "ArrayPriorityQueue", std::min(n,suite_array_cap), w);
+}
+
+template<class T, bool (*gt)(const T& a, const T& b), class Workload>
+void suite_array_row(const char*, int, const Workload&, std::true_type) {}
+
+template<class T, bool (*gt)(const T& a, const T& b), class Workload, class Handles>
+void suite_rows(const char* workload, int n, const Workload& w, Handles handles) {
+  suite_row<ics::FibPriorityQueue<T,gt>>         (workload, "FibPriorityQueue",          n, w);
+  suite_row<ics::CompactFibPriorityQueue<T,gt>>  (workload, "CompactFibPriorityQueue",   n, w);
+  suite_row<KeyedQueue<T,gt>>                    (workload, "KeyedFibPriorityQueue",     n, w);
+  suite_row<ics::StrictFibPriorityQueue<T,gt>>   (workload, "StrictFibPriorityQueue",    n, w);
+  suite_array_row<T,gt>                          (workload,                              n, w, handles);
+  suite_row<StdPriorityQueue<T,gt>>              (workload, "std::priority_queue",       n, w);
+}
+
+
+//Machine-readable: one CSV row per workload and queue (ns_per_op and mops_per_s count queue
+//  calls; see the workloads). "make run_bench_suite" saves one run to bin/bench_suite.csv
+void bench_suite(const std::vector<int>& sizes) {
+  std::vector<std::string> words;
+  std::ifstream english("english3.txt");
+  for (std::string word; std::getline(english,word); )
+    words.push_back(word);
+  std::shuffle(words.begin(),words.end(),std::mt19937(12345));
+
+  std::cout << "workload,queue,n,ops,ns_per_op,mops_per_s,peak_bytes" << std::endl;
+  for (int n : sizes) {
+    std::vector<long long> values;
+    for (int v : shuffled_values(n))
+      values.push_back(v);
+    suite_rows<long long,gt_llong>("insert",       n, Insert{values},      std::false_type());
+    suite_rows<long long,gt_llong>("insert_drain", n, InsertDrain{values}, std::false_type());
+    suite_rows<long long,gt_llong>("hold",         n, Hold{values},        std::false_type());
+    suite_rows<long long,gt_llong>("decrease_key", n, DecreaseKey{values}, std::true_type());
+    suite_rows<long long,gt_llong>("meld",         n, Meld{values},        std::false_type());
+    if (!words.empty())
+      suite_rows<std::string,gt_string>("strings", std::min(n,(int)words.size()), Strings{words}, std::false_type());
+  }
+  if (words.empty())
+    std::cout << "#strings skipped: english3.txt not found" << std::endl;
+  std::cout << std::endl;
+}
+
+
+//Sum of a range-for over a container of 10000 ints, repeated to visit n values in all
+template<class Container>
+double range_for_ns(const Container& c, int n) {
+  int passes = std::max(1, n/10000);
+  double checksum = 0;
+  Clock::time_point start = Clock::now();
+  for (int p=0; p<passes; ++p)
+    for (const int& v : c)
+      checksum += v;
+  sink = checksum;
+  return elapsed_ns(start)/passes/10000;
+}
+
+
+//Build with -DICS_UNCHECKED_ITERATORS ("make bench_unchecked") to compare
+void bench_iterate(const std::vector<int>& sizes) {
+  std::cout << "range-for, iterators " << (ics::checked_iterators ? "checked" : "unchecked")
+            << " (ns per value)" << std::endl;
+  std::cout << std::setw(10) << "n" << std::setw(10) << "vector" << std::setw(10) << "Stack" << std::setw(10) << "Queue"
+            << std::setw(10) << "Set" << std::setw(10) << "ArrayPQ" << std::setw(10) << "FibPQ" << std::endl;
+  std::vector<int> values = shuffled_values(10000);
+  ics::ArrayStack<int> stack;
+  ics::ArrayQueue<int> queue;
+  ics::ArraySet<int>   set;
+  ics::ArrayPriorityQueue<int,gt_int> array_pq;
+  PriorityQueueTypeInt fib_pq;
+  for (int v : values) {
+    stack.push(v);
+    queue.enqueue(v);
+    set.insert(v);
+    array_pq.enqueue(v);
+    fib_pq.enqueue(v);
+  }
+  fib_pq.enqueue(-1);
+  fib_pq.dequeue();
+
+  for (int n : sizes)
+    std::cout << std::setw(10) << n << std::fixed << std::setprecision(2)
+              << std::setw(10) << range_for_ns(values,n)
+              << std::setw(10) << range_for_ns(stack,n)
+              << std::setw(10) << range_for_ns(queue,n)
+              << std::setw(10) << range_for_ns(set,n)
+              << std::setw(10) << range_for_ns(array_pq,n)
+              << std::setw(10) << range_for_ns(fib_pq,n) << std::endl;
+  std::cout << std::endl;
+}
+
+
+int main(int argc, char** argv) {
+  std::string section;
+  std::vector<int> sizes;
+  for (int i=1; i<argc; ++i)
+    if (std::isdigit(argv[i][0]))
+      sizes.push_back(std::atoi(argv[i]));
+    else
+      section = argv[i];
+  if (sizes.empty())
+    sizes = {100000, 1000000, 10000000};
+
+  struct {const char* name; void (*run)(const std::vector<int>& sizes);} sections[] = {
+    {"consolidation",     bench_consolidation},
+    {"comparator",        bench_comparator},
+    {"large_scale_speed", bench_large_scale_speed},
+    {"keyed",             bench_keyed},
+    {"node_storage",      bench_node_storage},
+    {"peek_k",            bench_peek_k},
+    {"batch",             bench_batch},
+    {"poll",              bench_poll},
+    {"iterate",           bench_iterate},
+    {"copy",              bench_copy},
+    {"parallel",          bench_parallel},
+    {"stats",             bench_stats},
+    {"latency",           bench_latency},
+    {"incremental",       bench_incremental},
+    {"worst_case",        bench_worst_case},
+    {"suite",             bench_suite},
+  };
+  for (auto& s : sections)
+    if (section.empty() || section == s.name)
+      s.run(sizes);
+  return 0;
+}
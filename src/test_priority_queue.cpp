@@ -1,20 +1,48 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>                 // std::random_shuffle
+#include <set>                       // reference for handle_large_scale
+#include <map>
+#include <memory>                    // std::unique_ptr: move-only elements
+#include <functional>                // std::greater: Compare type
+#include <iterator>                  // std::back_inserter
 #include "courselib/ics46goody.hpp"
 #include "gtest/gtest.h"
 #include "array_stack.hpp"           // must leave in for constructor
 #include "array_priority_queue.hpp"  // must leave in for large_scale
 #include "fib_priority_queue.hpp"
+#include "keyed_fib_priority_queue.hpp"
+#include "compact_fib_priority_queue.hpp"
+#include "strict_fib_priority_queue.hpp"
+#include "timed_priority_queue.hpp"
 
 bool gt_string  (const std::string& a, const std::string& b) {return a < b;}
 bool gt_string2 (const std::string& a, const std::string& b) {return a > b;}
 bool gt_int     (const int& a, const int& b) {return a < b;}
+bool gt_uptr    (const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) {return *a < *b;}
+
+struct gt_string_functor {
+  bool operator () (const std::string& a, const std::string& b) const {return a < b;}
+};
+struct gt_string_by {               //stateful Compare: no default constructor
+  explicit gt_string_by(bool ascending) : ascending(ascending) {}
+  bool operator () (const std::string& a, const std::string& b) const {return ascending ? a < b : a > b;}
+  bool operator == (const gt_string_by& rhs) const {return ascending == rhs.ascending;}
+  bool ascending;
+};
+auto gt_string_lambda = [] (const std::string& a, const std::string& b) {return a < b;};
+bool gt_int_by_value (int a, int b) {return a > b;}
 
 typedef ics::FibPriorityQueue<std::string,gt_string>   PriorityQueueTypeStr;
 typedef ics::FibPriorityQueue<std::string,gt_string2>  PriorityQueueTypeStrR;
 typedef ics::FibPriorityQueue<int,gt_int>              PriorityQueueTypeInt;
 typedef ics::FibPriorityQueue<std::string>             PriorityQueueTypeNone;
+typedef ics::FibPriorityQueue<std::unique_ptr<int>,gt_uptr> PriorityQueueTypeMoveOnly;
+typedef ics::FibPriorityQueue<std::string,nullptr,gt_string_functor> PriorityQueueTypeFunctor;
+typedef ics::KeyedFibPriorityQueue<int,std::string,gt_int> PriorityQueueTypeKeyed;
+typedef ics::CompactFibPriorityQueue<int,gt_int>            PriorityQueueTypeCompact;
+typedef ics::StrictFibPriorityQueue<std::string,gt_string> PriorityQueueTypeStrictStr;
+typedef ics::StrictFibPriorityQueue<int,gt_int>            PriorityQueueTypeStrictInt;
 
 
 int test_size  = ics::prompt_int ("Enter large scale test size");
@@ -330,6 +358,158 @@ TEST_F(PriorityQueueTest, dequeue2) {
 }
 
 
+TEST_F(PriorityQueueTest, dequeue_n) {
+  PriorityQueueTypeStr q;
+  std::vector<std::string> out;
+  ASSERT_EQ(0,q.dequeue_n(3,std::back_inserter(out)));
+  ASSERT_EQ(0,q.drain_while([] (const std::string&) {return true;},std::back_inserter(out)));
+
+  load(q,"fcijbdegah");
+  ASSERT_EQ(3,q.dequeue_n(3,std::back_inserter(out)));       //from singleton roots
+  ASSERT_EQ((std::vector<std::string>{"a","b","c"}),out);
+  ASSERT_EQ(7,q.size());
+  ASSERT_EQ("d",q.peek());
+
+  out.clear();
+  ASSERT_EQ(4,q.drain_while([] (const std::string& v) {return v < "h";},std::back_inserter(out)));
+  ASSERT_EQ((std::vector<std::string>{"d","e","f","g"}),out);
+  ASSERT_EQ(3,q.size());
+  ASSERT_EQ("h",q.peek());
+  ASSERT_EQ(0,q.drain_while([] (const std::string& v) {return v < "h";},std::back_inserter(out)));
+
+  PriorityQueueTypeStr::Iterator it(q.begin());
+  out.clear();
+  ASSERT_EQ(3,q.dequeue_n(10,std::back_inserter(out)));
+  ASSERT_EQ((std::vector<std::string>{"h","i","j"}),out);
+  ASSERT_TRUE(q.empty());
+  ASSERT_THROW(++it,ics::ConcurrentModificationError);
+
+  //batches interleaved with enqueues, after cuts, against a multiset
+  PriorityQueueTypeInt lq;
+  std::multiset<int> expected;
+  std::vector<PriorityQueueTypeInt::Handle> handles(test_size);
+  for (int i=0; i<test_size; ++i) {
+    int v = ics::rand_range(0,test_size);
+    lq.enqueue(v,handles[i]);
+    expected.insert(v);
+  }
+  lq.enqueue(-1);
+  std::vector<int> lout;
+  ASSERT_EQ(1,lq.dequeue_n(1,std::back_inserter(lout)));   //builds trees; every handle still valid
+  for (int i=0; i<test_size/100; ++i) {
+    PriorityQueueTypeInt::Handle h = handles[ics::rand_range(0,test_size-1)];
+    expected.erase(expected.find(*h));
+    expected.insert(*h - 1);
+    lq.increase_priority(h,*h - 1);
+  }
+  while (!lq.empty()) {
+    int n = ics::rand_range(1,100);
+    lout.clear();
+    ASSERT_EQ(std::min(n,(int)expected.size()),lq.dequeue_n(n,std::back_inserter(lout)));
+    for (int v : lout) {
+      ASSERT_EQ(*expected.begin(),v);
+      expected.erase(expected.begin());
+    }
+    ASSERT_EQ((int)expected.size(),lq.size());
+    for (int i=0; i<n/4; ++i) {
+      int v = ics::rand_range(0,test_size);
+      lq.enqueue(v);
+      expected.insert(v);
+    }
+  }
+}
+
+
+TEST_F(PriorityQueueTest, try_peek_dequeue) {
+  PriorityQueueTypeStr q;
+  std::string* top = nullptr;
+  std::string value = "unchanged";
+  ASSERT_FALSE(q.try_peek(top));
+  ASSERT_EQ(nullptr,top);
+  ASSERT_FALSE(q.try_dequeue(value));
+  ASSERT_EQ("unchanged",value);
+
+  load(q,"fcijbdegah");
+  for (char c : std::string("abcdefghij")) {
+    ASSERT_TRUE(q.try_peek(top));
+    ASSERT_EQ(std::string(1,c),*top);
+    ASSERT_TRUE(q.try_dequeue(value));
+    ASSERT_EQ(std::string(1,c),value);
+  }
+  ASSERT_TRUE(q.empty());
+  ASSERT_FALSE(q.try_dequeue(value));
+  ASSERT_EQ("j",value);
+
+  ics::ArrayPriorityQueue<std::string,gt_string> aq;
+  ASSERT_FALSE(aq.try_peek(top));
+  ASSERT_FALSE(aq.try_dequeue(value));
+  load(aq,"cab");
+  ASSERT_TRUE(aq.try_peek(top));
+  ASSERT_EQ("a",*top);
+  ASSERT_TRUE(aq.try_dequeue(value));
+  ASSERT_EQ("a",value);
+  ASSERT_EQ(2,aq.size());
+  ASSERT_TRUE(aq.try_dequeue(value));
+  ASSERT_TRUE(aq.try_dequeue(value));
+  ASSERT_EQ("c",value);
+  ASSERT_FALSE(aq.try_dequeue(value));
+  ASSERT_EQ("c",value);
+}
+
+
+TEST_F(PriorityQueueTest, for_each) {
+  PriorityQueueTypeStr q;
+  std::string visited;
+  q.for_each([&visited] (const std::string& v) {visited += v;});
+  ASSERT_EQ("",visited);
+
+  load(q,"fcijbdegah");
+  ASSERT_EQ("a",q.dequeue());       //build trees of several levels
+  q.for_each([&visited] (const std::string& v) {visited += v;});
+  std::sort(visited.begin(),visited.end());
+  ASSERT_EQ("bcdefghij",visited);
+  ASSERT_EQ(9,q.size());
+}
+
+
+TEST_F(PriorityQueueTest, peek_k) {
+  PriorityQueueTypeStr q;
+  std::vector<std::string> top;
+  ASSERT_EQ(0,q.peek_k(3,std::back_inserter(top)));
+  ASSERT_TRUE(top.empty());
+
+  load(q,"fcijbdegah");
+  ASSERT_EQ(4,q.peek_k(4,std::back_inserter(top)));     //only roots
+  ASSERT_EQ((std::vector<std::string>{"a","b","c","d"}),top);
+
+  ASSERT_EQ("a",q.dequeue());       //build trees of several levels
+  PriorityQueueTypeStr::Iterator it(q.begin());
+  top.clear();
+  ASSERT_EQ(5,q.peek_k(5,std::back_inserter(top)));
+  ASSERT_EQ((std::vector<std::string>{"b","c","d","e","f"}),top);
+  ASSERT_EQ("c",*++it);             //not a modification
+  top.clear();
+  ASSERT_EQ(9,q.peek_k(20,std::back_inserter(top)));
+  ASSERT_EQ((std::vector<std::string>{"b","c","d","e","f","g","h","i","j"}),top);
+  ASSERT_EQ(0,q.peek_k(0,std::back_inserter(top)));
+  ASSERT_TRUE(unload(q,"bcdefghij"));
+
+  PriorityQueueTypeInt lq;
+  std::vector<int> values;
+  for (int i=0; i<test_size; ++i)
+    values.push_back(i%1000);
+  std::random_shuffle(values.begin(),values.end());
+  lq.enqueue_all(values);
+  lq.dequeue();
+  std::sort(values.begin(),values.end());
+  std::vector<int> ltop;
+  int k = test_size/10;
+  ASSERT_EQ(k,lq.peek_k(k,std::back_inserter(ltop)));
+  ASSERT_TRUE(std::equal(ltop.begin(),ltop.end(),values.begin()+1));
+  ASSERT_EQ(test_size-1,lq.size());
+}
+
+
 TEST_F(PriorityQueueTest, assignment) {
   PriorityQueueTypeStr q1,q2;
   load(q2,"fcijb");
@@ -354,6 +534,87 @@ TEST_F(PriorityQueueTest, assignment) {
 }
 
 
+TEST_F(PriorityQueueTest, deep_tree_copy) {
+  //Each round enqueues k1 < k2 < k3 (below everything), dequeues k1, so k2 becomes the root
+  //  over k3 and the old root, then erases k3: one tree, a chain test_size+1 nodes deep
+  PriorityQueueTypeInt q;
+  q.enqueue(0);
+  for (int i=0; i<test_size; ++i) {
+    PriorityQueueTypeInt::Handle k3;
+    q.enqueue(-3*i-3);
+    q.enqueue(-3*i-2);
+    q.enqueue(-3*i-1,k3);
+    ASSERT_EQ(-3*i-3,q.dequeue());
+    ASSERT_EQ(-3*i-1,q.erase(k3));
+  }
+  ASSERT_EQ(test_size+1,q.size());
+
+  PriorityQueueTypeInt copy(q);
+  ASSERT_EQ(q,copy);
+  PriorityQueueTypeInt assigned;
+  assigned.enqueue(1);
+  assigned = copy;
+  ASSERT_EQ(q,assigned);
+  copy.clear();
+  ASSERT_TRUE(copy.empty());
+
+  for (int i=test_size-1; i>=0; --i)
+    ASSERT_EQ(-3*i-2,assigned.dequeue());
+  ASSERT_EQ(0,assigned.dequeue());
+  ASSERT_TRUE(assigned.empty());
+}
+
+
+TEST_F(PriorityQueueTest, parallel_copy_clear) {
+  //Enough nodes for 4 threads; half consolidated into trees, half left as singleton roots
+  int n = 4*PriorityQueueTypeStr::PARALLEL_GRAIN;
+  std::vector<std::string> values;
+  for (int i=0; i<n; ++i)
+    values.push_back(std::to_string(i));
+  std::random_shuffle(values.begin(),values.end());
+  PriorityQueueTypeStr q;
+  q.set_parallelism(4);
+  q.enqueue_all(std::vector<std::string>(values.begin(),values.begin()+n/2));
+  for (int i=n/2; i<n; ++i)
+    q.enqueue(values[i]);
+
+  PriorityQueueTypeStr copy(q);
+  ASSERT_EQ(q,copy);
+  PriorityQueueTypeStr assigned;
+  assigned.set_parallelism(4);
+  load(assigned,"abc");
+  assigned = copy;
+  ASSERT_EQ(q,assigned);
+  copy.clear();
+  ASSERT_TRUE(copy.empty());
+  load(copy,"ba");
+  ASSERT_TRUE(unload(copy,"ab"));
+
+  //background release: clear returns with the queue empty and usable
+  assigned.set_background_release(true);
+  assigned.clear();
+  ASSERT_TRUE(assigned.empty());
+  load(assigned,"cab");
+  ASSERT_TRUE(unload(assigned,"abc"));
+  assigned = q;
+  ASSERT_EQ(q,assigned);
+
+  std::sort(values.begin(),values.end());
+  for (const std::string& v : values)
+    ASSERT_EQ(v,q.dequeue());
+
+  //a shared pool is copied into in parallel, but cleared in place
+  PriorityQueueTypeStr::Pool pool;
+  PriorityQueueTypeStr shared(pool);
+  shared.set_parallelism(4);
+  shared.set_background_release(true);
+  shared = assigned;
+  ASSERT_EQ(assigned,shared);
+  shared.clear();
+  ASSERT_TRUE(shared.empty());
+}
+
+
 TEST_F(PriorityQueueTest, iterator_plusplus) {
   PriorityQueueTypeStr q;
   load(q,"cbdea");
@@ -495,6 +756,68 @@ TEST_F(PriorityQueueTest, iterator_erase_heap_special_case) {
 }
 
 
+TEST_F(PriorityQueueTest, iterator_erase_large_scale) {
+  PriorityQueueTypeInt lq;
+  std::vector<int> values;
+  for (int i=0; i<test_size; ++i)
+    values.push_back(i);
+  std::random_shuffle(values.begin(),values.end());
+  for (int v : values)
+    lq.enqueue(v);
+  lq.dequeue();                     //build trees, so erasing must also cut
+
+  int expected = 1;
+  for (PriorityQueueTypeInt::Iterator it(lq.begin()); it != lq.end(); ++it) {
+    ASSERT_EQ(expected++,*it);
+    if (*it % 3 == 0) {
+      ASSERT_EQ(expected-1,it.erase());
+    }
+  }
+  ASSERT_EQ(test_size,expected);
+
+  std::vector<int> remaining;
+  for (int v=1; v<test_size; ++v)
+    if (v % 3 != 0)
+      remaining.push_back(v);
+  ASSERT_EQ((int)remaining.size(),lq.size());
+  for (int v : remaining)
+    ASSERT_EQ(v,lq.dequeue());
+  ASSERT_TRUE(lq.empty());
+}
+
+
+TEST_F(PriorityQueueTest, iterator_erase_duplicates) {
+  //Every value appears 4 times: erase the whole prefix below test_size/8 (nothing
+  //  iterated past yet), then one copy of each remaining value (erases interleaved with ++)
+  PriorityQueueTypeInt lq;
+  std::vector<int> values;
+  for (int i=0; i<test_size; ++i)
+    values.push_back(i/4);
+  std::random_shuffle(values.begin(),values.end());
+  for (int v : values)
+    lq.enqueue(v);
+  lq.enqueue(-1);
+  lq.dequeue();                     //build trees, so erasing must also cut
+
+  int cutoff = test_size/32;
+  std::multiset<int> expected(values.begin(),values.end());
+  int last_erased = -1;
+  for (PriorityQueueTypeInt::Iterator it(lq.begin()); it != lq.end(); ++it) {
+    int v = *it;
+    if (v < cutoff || v != last_erased) {
+      ASSERT_EQ(v,it.erase());
+      expected.erase(expected.find(v));
+      last_erased = v;
+    }
+  }
+
+  ASSERT_EQ((int)expected.size(),lq.size());
+  for (int v : expected)
+    ASSERT_EQ(v,lq.dequeue());
+  ASSERT_TRUE(lq.empty());
+}
+
+
 TEST_F(PriorityQueueTest, iterator_exception_concurrent_modification_error) {
   PriorityQueueTypeStr q;
   load(q,"fcijbdegabh");
@@ -505,6 +828,15 @@ TEST_F(PriorityQueueTest, iterator_exception_concurrent_modification_error) {
   ASSERT_THROW(++it,ics::ConcurrentModificationError);
   ASSERT_THROW(it++,ics::ConcurrentModificationError);
   ASSERT_THROW(*it,ics::ConcurrentModificationError);
+
+  //copy assignment frees the nodes a live iterator refers to
+  PriorityQueueTypeStr r;
+  load(r,"xyz");
+  PriorityQueueTypeStr::Iterator it2(q.begin());
+  q = r;
+  ASSERT_THROW(*it2,ics::ConcurrentModificationError);
+  ASSERT_THROW(++it2,ics::ConcurrentModificationError);
+  ASSERT_THROW(it2.erase(),ics::ConcurrentModificationError);
 }
 
 
@@ -537,6 +869,12 @@ TEST_F(PriorityQueueTest, constructors) {
   PriorityQueueTypeStr q4(qa);
   ASSERT_TRUE(unload(q4,"abcdefghij"));
 
+  //copy, different gt
+  PriorityQueueTypeNone q5({"f", "c", "i", "j", "b", "d", "e", "g", "a", "h"},gt_string);
+  q5.dequeue();
+  PriorityQueueTypeNone q5c(q5,gt_string2);
+  ASSERT_TRUE(unload(q5c,"jihgfedcb"));
+
   //iterator, different gt
   load(q,"fcijbdegah");
   PriorityQueueTypeNone q5r(q,gt_string2);
@@ -581,6 +919,854 @@ TEST_F(PriorityQueueTest, template_constructors) {
 }
 
 
+TEST_F(PriorityQueueTest, compare_type) {
+  //function supplied with a Compare type: must fail
+  ASSERT_THROW(PriorityQueueTypeFunctor q_f(gt_string),ics::TemplateFunctionError);
+
+  //empty Compare takes no space
+  ASSERT_LT(sizeof(PriorityQueueTypeFunctor),sizeof(PriorityQueueTypeStr));
+
+  PriorityQueueTypeFunctor q({"f","c","i","j","b","d","e","g","a","h"});
+  PriorityQueueTypeFunctor q_c(q);
+  ASSERT_TRUE(q == q_c);
+  PriorityQueueTypeFunctor q2;
+  load(q2,"lk");
+  ASSERT_EQ(2,q.merge(q2));
+  ASSERT_TRUE(unload(q,"abcdefghijkl"));
+  ASSERT_TRUE(unload(q_c,"abcdefghij"));
+
+  //stateful Compare supplied to the constructor
+  ics::FibPriorityQueue<std::string,nullptr,gt_string_by> q_s(gt_string_by(false));
+  load(q_s,"fcijbdegah");
+  ASSERT_TRUE(unload(q_s,"jihgfedcba"));
+
+  //stateful Compares order the same way only if they are ==
+  ics::FibPriorityQueue<std::string,nullptr,gt_string_by> q_up(gt_string_by(true)), q_up2(gt_string_by(true));
+  load(q_s,"fcb");
+  load(q_up,"eda");
+  load(q_up2,"hg");
+  ASSERT_THROW(q_up.merge(q_s),ics::TemplateFunctionError);
+  ASSERT_EQ(3,q_s.size());
+  ics::FibPriorityQueue<std::string,nullptr,gt_string_by> q_up_c(q_up);
+  ASSERT_TRUE(q_up == q_up_c);
+  q_up_c = q_s;
+  ASSERT_FALSE(q_up == q_up_c);
+  ASSERT_EQ(2,q_up.merge(q_up2));
+  ASSERT_TRUE(unload(q_up,"adegh"));
+  ASSERT_TRUE(unload(q_s,"fcb"));
+
+  //lambda Compare: no default constructor and no operator =, but copies and assignment work
+  typedef ics::FibPriorityQueue<std::string,nullptr,decltype(gt_string_lambda)> PriorityQueueTypeLambda;
+  PriorityQueueTypeLambda q_l(gt_string_lambda), q_l2(gt_string_lambda);
+  load(q_l,"fcijb");
+  load(q_l2,"dega");
+  PriorityQueueTypeLambda q_lc(q_l);
+  q_lc = q_l2;
+  ASSERT_EQ(4,q_l.merge(q_l2));
+  ASSERT_TRUE(unload(q_lc,"adeg"));
+  ASSERT_TRUE(unload(q_l,"abcdefgij"));
+
+  bool ascending = false;           //capturing lambda: stored as a member, copied by construction
+  auto by = [ascending] (const std::string& a, const std::string& b) {return ascending ? a < b : a > b;};
+  ics::FibPriorityQueue<std::string,nullptr,decltype(by)> q_by(by);
+  load(q_by,"cab");
+  ics::FibPriorityQueue<std::string,nullptr,decltype(by)> q_byc(q_by);
+  q_byc = q_by;
+  ASSERT_TRUE(unload(q_byc,"cba"));
+  ics::KeyedFibPriorityQueue<std::string,int,nullptr,decltype(by)> kq_by(by), kq_byc(by);
+  kq_by.enqueue("a",1);
+  kq_by.enqueue("b",2);
+  kq_byc = kq_by;
+  ASSERT_EQ("b",kq_byc.dequeue().first);
+
+  //a copy keeps the heap shape even when Compare (or the keyed queue's order) has no operator ==
+  int calls = 0;
+  auto counting = [&calls] (const int& a, const int& b) {++calls; return a < b;};
+  ics::FibPriorityQueue<int,nullptr,decltype(counting)> q_n(counting);
+  ics::KeyedFibPriorityQueue<int,std::string,nullptr,decltype(counting)> kq_n(counting);
+  for (int i=0; i<100; ++i) {
+    q_n.enqueue(i);
+    kq_n.enqueue(i,"v");
+  }
+  q_n.dequeue();
+  kq_n.dequeue();
+  calls = 0;
+  ics::FibPriorityQueue<int,nullptr,decltype(counting)> q_nc(q_n);
+  ics::KeyedFibPriorityQueue<int,std::string,nullptr,decltype(counting)> kq_nc(kq_n);
+  ASSERT_EQ(0,calls);
+  ASSERT_EQ(1,q_nc.dequeue());
+  ASSERT_EQ(1,kq_nc.dequeue().first);
+
+  //function pointer Compare of cgt's own type: the cgt protocol
+  typedef ics::FibPriorityQueue<std::string,nullptr,bool (*)(const std::string&,const std::string&)> PriorityQueueTypeFp;
+  ASSERT_THROW(PriorityQueueTypeFp q_fn,ics::TemplateFunctionError);
+  PriorityQueueTypeFp q_fp(gt_string2);
+  load(q_fp,"bca");
+  PriorityQueueTypeFp q_fpc(q_fp);
+  ASSERT_TRUE(q_fp == q_fpc);
+  ASSERT_TRUE(unload(q_fpc,"cba"));
+
+  //any other function pointer Compare is supplied as a Compare object
+  typedef ics::FibPriorityQueue<int,nullptr,bool (*)(int,int)> PriorityQueueTypeFpValue;
+  ASSERT_THROW(PriorityQueueTypeFpValue q_vn,ics::TemplateFunctionError);
+  PriorityQueueTypeFpValue q_v(gt_int_by_value), q_v2(gt_int_by_value);
+  q_v.enqueue(1);
+  q_v2.enqueue(3);
+  q_v2.enqueue(2);
+  PriorityQueueTypeFpValue q_vc(q_v2);
+  q_vc = q_v;
+  ASSERT_EQ(2,q_v.merge(q_v2));
+  ASSERT_EQ(3,q_v.dequeue());
+  ASSERT_EQ(1,q_vc.dequeue());
+
+  ics::ArrayPriorityQueue<int,nullptr,std::greater<int>> aq({3,1,4,1,5});
+  ASSERT_EQ(5,aq.dequeue());
+  ASSERT_EQ(4,aq.dequeue());
+  ASSERT_EQ(3,aq.dequeue());
+}
+
+
+TEST_F(PriorityQueueTest, shared_pool) {
+  PriorityQueueTypeStr::Pool pool;
+  {
+    PriorityQueueTypeStr q1(pool), q2(pool);
+    load(q1,"fcijbdegah");
+    load(q2,"jihgfedcba");
+    ASSERT_EQ(q1,q2);
+    ASSERT_TRUE(unload(q1,"abcde"));
+    load(q1,"edcba");               //recycles storage freed by q1's dequeues
+    q2.clear();
+    ASSERT_TRUE(q2.empty());
+    ASSERT_TRUE(unload(q1,"abcdefghij"));
+  }
+  PriorityQueueTypeStr q3(pool);    //pool outlives (and is reused after) the queues sharing it
+  load(q3,"cba");
+  ASSERT_TRUE(unload(q3,"abc"));
+}
+
+
+TEST_F(PriorityQueueTest, handle_increase_priority) {
+  PriorityQueueTypeStr q;
+  PriorityQueueTypeStr::Handle hf, hj;
+  load(q,"cdeghik");
+  ASSERT_EQ(1,q.enqueue("f",hf));
+  ASSERT_EQ(1,q.enqueue("j",hj));
+  ASSERT_EQ("f",*hf);
+  ASSERT_EQ("j",*hj);
+  ASSERT_EQ("c",q.dequeue());   //consolidates, so f and j may now have parents
+
+  ASSERT_EQ(1,q.increase_priority(hj,"a"));
+  ASSERT_EQ("a",q.peek());
+  ASSERT_EQ(0,q.increase_priority(hf,"z"));
+  ASSERT_EQ("f",*hf);
+  ASSERT_EQ(1,q.increase_priority(hf,"b"));
+  ASSERT_EQ(8,q.size());
+  ASSERT_TRUE(unload(q,"abdeghik"));
+}
+
+
+TEST_F(PriorityQueueTest, handle_erase) {
+  std::string values = "fcijbdegah";
+  PriorityQueueTypeStr q;
+  PriorityQueueTypeStr::Handle h[10];
+  for (int i=0; i<10; ++i)
+    q.enqueue(std::string(1,values[i]),h[i]);
+  ASSERT_EQ("a",q.dequeue());
+
+  ASSERT_EQ("e",q.erase(h[6]));
+  ASSERT_EQ("j",q.erase(h[3]));
+  ASSERT_EQ("b",q.erase(h[4]));   //the head
+  ASSERT_EQ(6,q.size());
+  ASSERT_TRUE(unload(q,"cdfghi"));
+
+  //duplicate values: the handle, not the value, decides which node goes
+  PriorityQueueTypeStr::Handle x1, x2;
+  q.enqueue("x",x1);
+  q.enqueue("x",x2);
+  q.enqueue("y");
+  ASSERT_EQ("x",q.erase(x1));
+  ASSERT_EQ(1,q.increase_priority(x2,"a"));
+  ASSERT_TRUE(unload(q,"ay"));
+}
+
+
+TEST_F(PriorityQueueTest, handle_large_scale) {
+  PriorityQueueTypeInt lq;
+  std::multiset<int> ref;
+  std::vector<PriorityQueueTypeInt::Handle> handles;
+  std::vector<int> keys;
+  for (int i=0; i<test_size; ++i)
+    keys.push_back(i);
+  std::random_shuffle(keys.begin(),keys.end());
+
+  //keys stay unique, so a dequeued value identifies its handle
+  handles.resize(test_size);
+  std::map<int,int> owner;
+  for (int i=0; i<test_size; ++i) {
+    lq.enqueue(keys[i],handles[i]);
+    ref.insert(keys[i]);
+    owner[keys[i]] = i;
+  }
+  std::vector<bool> live(test_size,true);
+  int next_key = 0;
+  for (int step=0; step<2*test_size; ++step) {
+    int i = ics::rand_range(0,test_size-1);
+    if (!live[i])
+      continue;
+    int action = ics::rand_range(0,3);
+    if (action == 0) {
+      ASSERT_EQ(keys[i],lq.erase(handles[i]));
+      ref.erase(ref.find(keys[i]));
+      live[i] = false;
+    } else if (action == 1 && !lq.empty()) {
+      int top = lq.dequeue();
+      ASSERT_EQ(*ref.begin(),top);
+      ref.erase(ref.begin());
+      live[owner[top]] = false;         //retire the handle whose element left
+    } else {
+      int k = --next_key;
+      ASSERT_EQ(1,lq.increase_priority(handles[i],k));
+      ref.erase(ref.find(keys[i]));
+      ref.insert(k);
+      keys[i] = k;
+      owner[k] = i;
+    }
+    ASSERT_EQ((int)ref.size(),lq.size());
+    if (!ref.empty()) {
+      ASSERT_EQ(*ref.begin(),lq.peek());
+    }
+  }
+}
+
+
+TEST_F(PriorityQueueTest, merge) {
+  PriorityQueueTypeStr q1, q2;
+  load(q1,"fcijb");
+  load(q2,"degah");
+  ASSERT_EQ("b",q1.dequeue());     //merge trees, not just singletons
+  PriorityQueueTypeStr::Handle hz;
+  q2.enqueue("z",hz);
+  ASSERT_EQ(6,q1.merge(q2));
+  ASSERT_TRUE(q2.empty());
+  ASSERT_EQ(0,q2.size());
+  ASSERT_EQ(10,q1.size());
+  ASSERT_EQ("a",q1.peek());
+  ASSERT_EQ(1,q1.increase_priority(hz,"b"));   //handles follow their elements
+  ASSERT_TRUE(unload(q1,"abcdefghij"));
+
+  load(q2,"cba");                   //q2 is still usable
+  ASSERT_EQ(3,q1.meld(std::move(q2)));
+  ASSERT_EQ(0,q1.merge(q1));
+  ASSERT_TRUE(unload(q1,"abc"));
+
+  //q2 shares a pool with some other queue: elements are moved one by one
+  PriorityQueueTypeStr::Pool pool;
+  PriorityQueueTypeStr q3(pool);
+  load(q1,"ec");
+  load(q3,"dab");
+  ASSERT_EQ(3,q1.merge(q3));
+  ASSERT_TRUE(q3.empty());
+  ASSERT_TRUE(unload(q1,"abcde"));
+
+  PriorityQueueTypeNone q4(gt_string), q5(gt_string2);
+  ASSERT_THROW(q4.merge(q5),ics::TemplateFunctionError);
+
+  //owned pools of many slabs are spliced together, then reused
+  PriorityQueueTypeInt lq;
+  for (int k=0; k<4; ++k) {
+    PriorityQueueTypeInt part;
+    for (int i=k; i<20000; i+=4)
+      part.enqueue(i);
+    part.dequeue();                   //leaves a slot on part's free list
+    ASSERT_EQ(4999,lq.merge(part));
+  }
+  for (int k=0; k<4; ++k)
+    lq.enqueue(k);
+  for (int i=0; i<20000; ++i)
+    ASSERT_EQ(i,lq.dequeue());
+  ASSERT_TRUE(lq.empty());
+}
+
+
+TEST_F(PriorityQueueTest, node_pool_adopt) {
+  //per-worker pools adopted every epoch: capacity stays proportional to what was allocated
+  ics::NodePool<std::string> main, worker;
+  for (int epoch=0; epoch<1000; ++epoch) {
+    for (int i=0; i<10; ++i)
+      ASSERT_NE(nullptr,worker.allocate());
+    main.adopt(worker);
+    ASSERT_EQ(0,worker.capacity());
+    ASSERT_EQ(0,worker.slab_count());
+  }
+  ASSERT_LE(main.capacity(),3*10*1000);
+
+  //every slot counted by capacity() is usable without carving a new slab
+  int slabs = main.slab_count();
+  for (int i=10*1000; i<main.capacity(); ++i)
+    ASSERT_NE(nullptr,main.allocate());
+  ASSERT_EQ(slabs,main.slab_count());
+  main.allocate();
+  ASSERT_EQ(slabs+1,main.slab_count());
+}
+
+
+TEST_F(PriorityQueueTest, move_semantics) {
+  PriorityQueueTypeStr q1;
+  load(q1,"fcijb");
+  PriorityQueueTypeStr q2(std::move(q1));
+  ASSERT_TRUE(q1.empty());
+  ASSERT_EQ(5,q2.size());
+  load(q1,"ed");                   //moved-from queue is still usable
+  ASSERT_TRUE(unload(q1,"de"));
+
+  q1 = std::move(q2);
+  ASSERT_TRUE(q2.empty());
+  ASSERT_TRUE(unload(q1,"bcfij"));
+
+  PriorityQueueTypeNone q3(gt_string2);
+  load(q3,"abc");
+  q3 = PriorityQueueTypeNone({"x","y"},gt_string);   //takes the temporary's gt too
+  ASSERT_TRUE(unload(q3,"xy"));
+
+  std::string s("h");
+  ASSERT_EQ(1,q3.enqueue(std::move(s)));
+  ASSERT_EQ(1,q3.emplace(3,'g'));
+  ASSERT_EQ("ggg",q3.dequeue());
+  ASSERT_EQ("h",q3.dequeue());
+}
+
+
+TEST_F(PriorityQueueTest, move_only_elements) {
+  PriorityQueueTypeMoveOnly q;
+  for (int v : {5,3,8,1,9,2})
+    q.enqueue(std::unique_ptr<int>(new int(v)));
+  ASSERT_EQ(1,q.emplace(new int(7)));
+  PriorityQueueTypeMoveOnly::Handle h;
+  q.enqueue(std::unique_ptr<int>(new int(10)),h);
+  ASSERT_EQ(1,*q.dequeue());
+  ASSERT_EQ(1,q.increase_priority(h,std::unique_ptr<int>(new int(0))));
+
+  PriorityQueueTypeMoveOnly q2(std::move(q));
+  q2.merge(q);
+  q = std::move(q2);
+  int expected[] = {0,2,3,5,7,8,9};
+  for (int e : expected) {
+    std::unique_ptr<int> p = q.dequeue();
+    ASSERT_EQ(e,*p);
+  }
+  ASSERT_TRUE(q.empty());
+}
+
+
+TEST_F(PriorityQueueTest, keyed) {
+  PriorityQueueTypeKeyed q;
+  ASSERT_THROW(q.peek(),ics::EmptyError);
+  ASSERT_THROW(q.dequeue(),ics::EmptyError);
+
+  PriorityQueueTypeKeyed::Handle h3, h9;
+  q.enqueue(5,"five");
+  q.enqueue(3,std::string("three"),h3);
+  q.enqueue(9,std::string("nine"),h9);
+  q.enqueue(1,"one");
+  ASSERT_EQ(4,q.size());
+  ASSERT_EQ(ics::make_pair(1,std::string("one")),q.peek());
+  ASSERT_EQ(1,q.peek_key());
+  q.peek_value() = "ONE";
+
+  ASSERT_EQ(1,q.increase_priority(h9,0));
+  ASSERT_EQ(0,q.increase_priority(h3,4));
+  ASSERT_EQ(3,h3.key());
+  ASSERT_EQ(ics::make_pair(3,std::string("three")),q.erase(h3));
+
+  PriorityQueueTypeKeyed q_c(q);
+  ASSERT_EQ(ics::make_pair(0,std::string("nine")),q.dequeue());
+  ASSERT_EQ(ics::make_pair(1,std::string("ONE")),q.dequeue());
+  q.enqueue(2,"two");                         //reuses a free slot
+  ASSERT_EQ(ics::make_pair(2,std::string("two")),q.dequeue());
+  ASSERT_EQ(ics::make_pair(5,std::string("five")),q.dequeue());
+  ASSERT_TRUE(q.empty());
+  ASSERT_EQ(3,q_c.size());
+  ASSERT_EQ(0,q_c.peek_key());
+
+  ics::KeyedFibPriorityQueue<int,std::string,nullptr,std::greater<int>> q_g;
+  q_g.enqueue(1,"low");
+  q_g.enqueue(2,"high");
+  ASSERT_EQ("high",q_g.dequeue().second);
+}
+
+
+TEST_F(PriorityQueueTest, compact) {
+  PriorityQueueTypeCompact q;
+  ASSERT_THROW(q.peek(),ics::EmptyError);
+  ASSERT_THROW(q.dequeue(),ics::EmptyError);
+  ASSERT_THROW(ics::CompactFibPriorityQueue<int> q_f,ics::TemplateFunctionError);
+
+  //random enqueues, dequeues, and increases, checked against a multiset; keys are unique
+  //  (increases take fresh keys below all others) so each handle's value is known
+  std::vector<int> keys;
+  for (int i=0; i<test_size; ++i)
+    keys.push_back(test_size+i);
+  std::random_shuffle(keys.begin(),keys.end());
+  std::multiset<int> expected;
+  std::map<int,PriorityQueueTypeCompact::Handle> handles;
+  int next_key = test_size;
+  for (int k : keys) {
+    PriorityQueueTypeCompact::Handle h;
+    q.enqueue(k,h);
+    handles[k] = h;
+    expected.insert(k);
+    if (ics::rand_range(0,3) == 0) {
+      ASSERT_EQ(*expected.begin(),q.dequeue());
+      handles.erase(*expected.begin());
+      expected.erase(expected.begin());
+    }
+    if (ics::rand_range(0,3) == 0) {
+      std::map<int,PriorityQueueTypeCompact::Handle>::iterator owner = handles.upper_bound(ics::rand_range(test_size,2*test_size));
+      if (owner != handles.end()) {
+        ASSERT_EQ(1,q.increase_priority(owner->second,--next_key));
+        ASSERT_EQ(0,q.increase_priority(owner->second,3*test_size));
+        expected.erase(owner->first);
+        expected.insert(next_key);
+        handles[next_key] = owner->second;
+        handles.erase(owner);
+      }
+    }
+  }
+
+  ASSERT_EQ((int)expected.size(),q.size());
+  int sum = 0, expected_sum = 0;
+  q.for_each([&sum] (const int& v) {sum += v;});
+  for (int v : expected)
+    expected_sum += v;
+  ASSERT_EQ(expected_sum,sum);
+
+  PriorityQueueTypeCompact q_c(q);
+  for (int v : expected)
+    ASSERT_EQ(v,q.dequeue());
+  ASSERT_TRUE(q.empty());
+  ASSERT_EQ((int)expected.size(),q_c.size());
+  ASSERT_EQ(*expected.begin(),q_c.peek());
+}
+
+
+TEST_F(PriorityQueueTest, strict_fib) {
+  PriorityQueueTypeStrictStr q;
+  ASSERT_TRUE(q.empty());
+  ASSERT_THROW(q.peek(),ics::EmptyError);
+  ASSERT_THROW(q.dequeue(),ics::EmptyError);
+  ASSERT_THROW(ics::StrictFibPriorityQueue<std::string> q_f,ics::TemplateFunctionError);
+
+  load(q,"fcijbdegah");
+  ASSERT_EQ(10,q.size());
+  ASSERT_EQ("a",q.peek());
+  std::ostringstream out;
+  out << q;
+  ASSERT_EQ("priority_queue[j,i,h,g,f,e,d,c,b,a]:highest",out.str());
+
+  PriorityQueueTypeStrictStr q_c(q);
+  ASSERT_EQ(q,q_c);
+  ASSERT_EQ("a",q_c.dequeue());
+  ASSERT_NE(q,q_c);
+  PriorityQueueTypeStrictStr q_m(std::move(q_c));
+  ASSERT_TRUE(q_c.empty());
+  ASSERT_TRUE(unload(q_m,"bcdefghij"));
+  q_c = q;
+  ASSERT_EQ(q,q_c);
+
+  //handles, and merge (handles into q2 follow their elements)
+  PriorityQueueTypeStrictStr::Handle hz, hy;
+  q.enqueue("z",hz);
+  q.enqueue("y",hy);
+  ASSERT_EQ(1,q.increase_priority(hz,"b"));
+  ASSERT_EQ(0,q.increase_priority(hz,"x"));
+  ASSERT_EQ("y",q.erase(hy));
+  PriorityQueueTypeStrictStr q2;
+  PriorityQueueTypeStrictStr::Handle hk;
+  load(q2,"mlk");
+  q2.enqueue("w",hk);
+  ASSERT_EQ(4,q.merge(q2));
+  ASSERT_TRUE(q2.empty());
+  ASSERT_EQ(1,q.increase_priority(hk,"0"));
+  ASSERT_EQ(0,q.merge(q));
+  ASSERT_TRUE(unload(q,"0abbcdefghijklm"));
+
+  ics::StrictFibPriorityQueue<std::string> q4(gt_string), q5(gt_string2);
+  ASSERT_THROW(q4.merge(q5),ics::TemplateFunctionError);
+}
+
+
+TEST_F(PriorityQueueTest, strict_fib_iterator) {
+  PriorityQueueTypeStrictStr q;
+  load(q,"fcijbdegah");
+  std::string order;
+  for (const std::string& x : q)
+    order += x;
+  ASSERT_EQ("abcdefghij",order);
+
+  PriorityQueueTypeStrictStr::Iterator it(q.begin());
+  ++it;
+  ASSERT_EQ("b",it.erase());
+  ASSERT_THROW(it.erase(),ics::CannotEraseError);
+  ASSERT_THROW(*it,ics::IteratorPositionIllegal);
+  ++it; //to "c"
+  ++it; //to "d"
+  ASSERT_EQ("d",it.erase());
+  q.dequeue();
+  ASSERT_THROW(++it,ics::ConcurrentModificationError);
+  ASSERT_TRUE(unload(q,"cefghij"));
+
+  //every value 4 times: erase 1 copy of each (interleaved with ++), after building trees
+  PriorityQueueTypeStrictInt lq;
+  std::vector<int> values;
+  for (int i=0; i<test_size; ++i)
+    values.push_back(i/4);
+  std::random_shuffle(values.begin(),values.end());
+  for (int v : values)
+    lq.enqueue(v);
+  for (int i=0; i<test_size/10; ++i)
+    lq.dequeue();
+  std::multiset<int> expected(values.begin(),values.end());
+  while ((int)expected.size() > lq.size())
+    expected.erase(expected.begin());
+  int last_erased = -1, visited = 0;
+  for (PriorityQueueTypeStrictInt::Iterator i(lq.begin()); i != lq.end(); ++i, ++visited) {
+    int v = *i;
+    if (v != last_erased) {
+      ASSERT_EQ(v,i.erase());
+      expected.erase(expected.find(v));
+      last_erased = v;
+    }
+  }
+  ASSERT_EQ(test_size-test_size/10,visited);
+  ASSERT_EQ((int)expected.size(),lq.size());
+  for (int v : expected)
+    ASSERT_EQ(v,lq.dequeue());
+}
+
+
+TEST_F(PriorityQueueTest, strict_fib_large_scale) {
+  //random operations against a reference; keys stay unique, so a dequeued value identifies its handle
+  PriorityQueueTypeStrictInt lq, other;
+  std::multiset<int> ref;
+  std::vector<PriorityQueueTypeStrictInt::Handle> handles(test_size);
+  std::vector<int> keys(test_size);
+  std::vector<bool> live(test_size,false);
+  std::map<int,int> owner;
+  int next_key = 0;
+  for (int step=0; step<4*test_size; ++step) {
+    int i = ics::rand_range(0,test_size-1);
+    int action = ics::rand_range(0,9);
+    if (!live[i] && action > 2) {
+      keys[i] = ics::rand_range(0,test_size);
+      while (owner.count(keys[i]) != 0)
+        ++keys[i];
+      //every so often through another queue, merged back in at once: either way round, so
+      //  the smaller queue's structure is sometimes the one kept
+      (action == 9 ? other : lq).enqueue(keys[i],handles[i]);
+      if (action == 9 && step%2 == 0)
+        lq.merge(other);
+      else if (action == 9) {
+        other.merge(lq);
+        lq = std::move(other);
+      }
+      ref.insert(keys[i]);
+      owner[keys[i]] = i;
+      live[i] = true;
+    } else if (action == 0 && !lq.empty()) {
+      int top = lq.dequeue();
+      ASSERT_EQ(*ref.begin(),top);
+      ref.erase(ref.begin());
+      live[owner[top]] = false;         //retire the handle whose element left
+      owner.erase(top);
+    } else if (action == 1 && live[i]) {
+      ASSERT_EQ(keys[i],lq.erase(handles[i]));
+      ref.erase(ref.find(keys[i]));
+      owner.erase(keys[i]);
+      live[i] = false;
+    } else if (action == 2 && live[i]) {
+      int k = --next_key;
+      ASSERT_EQ(1,lq.increase_priority(handles[i],k));
+      ref.erase(ref.find(keys[i]));
+      owner.erase(keys[i]);
+      ref.insert(k);
+      keys[i] = k;
+      owner[k] = i;
+    }
+    ASSERT_EQ((int)ref.size(),lq.size());
+    if (!ref.empty()) {
+      ASSERT_EQ(*ref.begin(),lq.peek());
+    }
+  }
+
+  PriorityQueueTypeStrictInt copy(lq);
+  std::vector<int> rest(ref.begin(),ref.end());
+  for (int v : rest)
+    ASSERT_EQ(v,lq.dequeue());
+  ASSERT_TRUE(lq.empty());
+  int n = 0;
+  for (int v : copy)
+    ASSERT_EQ(rest[n++],v);
+  ASSERT_EQ((int)rest.size(),n);
+}
+
+
+TEST_F(PriorityQueueTest, strict_fib_random_merges) {
+  //several queues, each checked against its own reference, build up structure (active nodes,
+  //  losses) before they are merged; increases go to any unused smaller key, not just the top
+  const int queues = 4;
+  PriorityQueueTypeStrictInt q[queues];
+  std::set<int> ref[queues];
+  std::vector<PriorityQueueTypeStrictInt::Handle> handles(test_size);
+  std::vector<int> keys(test_size);
+  std::vector<bool> live(test_size,false);
+  std::map<int,int> owner;
+  auto queue_of = [&ref] (int key) {int w = 0; while (ref[w].count(key) == 0) ++w; return w;};
+  for (int step=0; step<4*test_size; ++step) {
+    int i = ics::rand_range(0,test_size-1);
+    int w = ics::rand_range(0,queues-1);
+    int action = ics::rand_range(0,19);
+    if (!live[i] && action > 8) {
+      keys[i] = ics::rand_range(0,10*test_size);
+      while (owner.count(keys[i]) != 0)
+        ++keys[i];
+      q[w].enqueue(keys[i],handles[i]);
+      ref[w].insert(keys[i]);
+      owner[keys[i]] = i;
+      live[i] = true;
+    } else if (action <= 2 && !q[w].empty()) {
+      int top = q[w].dequeue();
+      ASSERT_EQ(*ref[w].begin(),top);
+      ref[w].erase(ref[w].begin());
+      live[owner[top]] = false;
+      owner.erase(top);
+    } else if (action == 3 && live[i]) {
+      w = queue_of(keys[i]);
+      ASSERT_EQ(keys[i],q[w].erase(handles[i]));
+      ref[w].erase(keys[i]);
+      owner.erase(keys[i]);
+      live[i] = false;
+    } else if (action <= 7 && live[i]) {
+      w = queue_of(keys[i]);
+      int k = keys[i] - ics::rand_range(1,test_size);
+      while (owner.count(k) != 0)
+        --k;
+      ASSERT_EQ(1,q[w].increase_priority(handles[i],k));
+      ref[w].erase(keys[i]);
+      owner.erase(keys[i]);
+      ref[w].insert(k);
+      keys[i] = k;
+      owner[k] = i;
+    } else if (action == 8) {
+      int v = (w + ics::rand_range(1,queues-1)) % queues;
+      ASSERT_EQ((int)ref[v].size(),q[w].merge(q[v]));
+      ASSERT_TRUE(q[v].empty());
+      if (ref[v].size() > ref[w].size())
+        ref[v].swap(ref[w]);
+      ref[w].insert(ref[v].begin(),ref[v].end());
+      ref[v].clear();
+    }
+    ASSERT_EQ((int)ref[w].size(),q[w].size());
+    if (!ref[w].empty()) {
+      ASSERT_EQ(*ref[w].begin(),q[w].peek());
+    }
+  }
+
+  for (int w=0; w<queues; ++w) {
+    for (int k : ref[w])
+      ASSERT_EQ(k,q[w].dequeue());
+    ASSERT_TRUE(q[w].empty());
+  }
+}
+
+
+TEST_F(PriorityQueueTest, stats) {
+  PriorityQueueTypeInt q;
+  PriorityQueueTypeInt::Handle h8;
+  for (int i=0; i<8; ++i)
+    q.enqueue(i);
+  q.enqueue(8,h8);
+  ASSERT_EQ(0,q.dequeue());         //links the other 8 singletons into one tree of degree 3
+  ASSERT_EQ(1,q.increase_priority(h8,-1));
+  q.clear();
+
+  const ics::FibQueueStats& s = q.stats();
+  if (!ics::queue_stats) {          //not compiled with -DICS_QUEUE_STATS: nothing is counted or stored
+    ASSERT_TRUE(std::is_empty<ics::FibQueueStatsStorage<>>::value);
+    ASSERT_EQ(0,s.comparisons);
+    ASSERT_EQ(0,s.allocations);
+    ASSERT_EQ(0,s.links);
+    return;
+  }
+  ASSERT_EQ(1,s.consolidations);
+  ASSERT_EQ(8,s.roots);
+  ASSERT_EQ(8,s.maxRoots);
+  ASSERT_EQ(7,s.links);
+  ASSERT_EQ(3,s.maxDegree);
+  ASSERT_EQ(1,s.cuts);              //h8's parent was not marked: no cascade
+  ASSERT_EQ(0,s.cascadingCuts);
+  ASSERT_EQ(1,s.maxCutDepth);
+  ASSERT_LT(0,s.comparisons);
+  ASSERT_EQ(9,s.allocations);
+  ASSERT_EQ(9,s.frees);
+  ASSERT_NE(std::string::npos,s.str().find("links=7"));
+
+  PriorityQueueTypeInt copy;
+  q.enqueue(1);
+  copy = q;
+  ASSERT_EQ(10,s.allocations);      //the copied nodes are counted by copy
+  ASSERT_EQ(1,copy.stats().allocations);
+  q.reset_stats();
+  ASSERT_EQ(0,s.allocations);
+  ASSERT_EQ(0,s.comparisons);
+}
+
+
+TEST_F(PriorityQueueTest, incremental_consolidation) {
+  PriorityQueueTypeStr q;
+  q.set_consolidation_budget(2);
+  load(q,"hgfedcba");
+  ASSERT_EQ("a",q.peek());
+  PriorityQueueTypeStr::Handle hz;
+  q.enqueue("z",hz);
+  ASSERT_EQ(1,q.increase_priority(hz,"c"));
+  PriorityQueueTypeStr q2;
+  load(q2,"kji");
+  ASSERT_EQ(3,q.merge(q2));         //q2's roots are absorbed by later calls
+  ASSERT_EQ("a",q.dequeue());
+  for (auto i = q.begin(); i != q.end(); ++i)
+    if (*i == "e" || *i == "j")
+      i.erase();
+  PriorityQueueTypeStr copy(q);
+  q.set_consolidation_budget(0);    //back to full consolidation mid-stream
+  ASSERT_TRUE(unload(q,"bccdfghik"));
+  ASSERT_TRUE(unload(copy,"bccdfghik"));
+
+  //random operations against a reference, toggling the budget now and then
+  PriorityQueueTypeInt lq;
+  lq.set_consolidation_budget(1);
+  std::multiset<int> ref;
+  std::vector<PriorityQueueTypeInt::Handle> handles(test_size);
+  std::vector<int> keys(test_size);
+  std::vector<bool> live(test_size,false);
+  std::map<int,int> owner;         //keys stay unique, so a dequeued value identifies its handle
+  int next_key = 0;
+  for (int step=0; step<4*test_size; ++step) {
+    int i = ics::rand_range(0,test_size-1);
+    int action = ics::rand_range(0,9);
+    if (!live[i] && action > 2) {
+      keys[i] = ics::rand_range(0,test_size);
+      while (owner.count(keys[i]) != 0)
+        ++keys[i];
+      lq.enqueue(keys[i],handles[i]);
+      ref.insert(keys[i]);
+      owner[keys[i]] = i;
+      live[i] = true;
+    } else if (action == 0 && !lq.empty()) {
+      int top = lq.dequeue();
+      ASSERT_EQ(*ref.begin(),top);
+      ref.erase(ref.begin());
+      live[owner[top]] = false;         //retire the handle whose element left
+      owner.erase(top);
+    } else if (action == 1 && live[i]) {
+      ASSERT_EQ(keys[i],lq.erase(handles[i]));
+      ref.erase(ref.find(keys[i]));
+      owner.erase(keys[i]);
+      live[i] = false;
+    } else if (action == 2 && live[i]) {
+      int k = --next_key;
+      ASSERT_EQ(1,lq.increase_priority(handles[i],k));
+      ref.erase(ref.find(keys[i]));
+      owner.erase(keys[i]);
+      ref.insert(k);
+      keys[i] = k;
+      owner[k] = i;
+    } else if (action == 3 && step%97 == 0) {
+      lq.set_consolidation_budget(step%2 == 0 ? 0 : ics::rand_range(1,8));
+    }
+    ASSERT_EQ((int)ref.size(),lq.size());
+    if (!ref.empty()) {
+      ASSERT_EQ(*ref.begin(),lq.peek());
+    }
+  }
+  std::vector<int> rest(ref.begin(),ref.end());
+  for (int v : rest)
+    ASSERT_EQ(v,lq.dequeue());
+}
+
+
+TEST_F(PriorityQueueTest, latency_histogram) {
+  ics::LatencyHistogram h;
+  ASSERT_EQ(0,h.percentile(99));
+  for (int v=1; v<=1000; ++v)
+    h.record(v*1000);
+  ASSERT_EQ(1000,h.count());
+  ASSERT_EQ(1000,h.min());
+  ASSERT_EQ(1000000,h.max());
+  ASSERT_DOUBLE_EQ(500500,h.mean());
+  for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    long long exact = (long long)(p*10+0.5)*1000;
+    ASSERT_TRUE(exact <= h.percentile(p));
+    ASSERT_TRUE(h.percentile(p) <= exact+exact/ics::LatencyHistogram::SUB_BUCKETS);
+  }
+  ASSERT_EQ(1000000,h.percentile(100));
+  for (int b=0; b<ics::LatencyHistogram::BUCKETS-1; ++b) {
+    ASSERT_EQ(b,ics::LatencyHistogram::bucket(ics::LatencyHistogram::bucketHigh(b)));
+    ASSERT_EQ(b+1,ics::LatencyHistogram::bucket(ics::LatencyHistogram::bucketHigh(b)+1));
+  }
+
+  ics::LatencyHistogram h2;
+  h2.record(5);
+  h.merge(h2);
+  ASSERT_EQ(1001,h.count());
+  ASSERT_EQ(5,h.min());
+  h.reset();
+  ASSERT_EQ(0,h.count());
+}
+
+
+TEST_F(PriorityQueueTest, timed) {
+  typedef ics::TimedPriorityQueue<PriorityQueueTypeStr>                        TimedFib;
+  typedef ics::TimedPriorityQueue<ics::ArrayPriorityQueue<std::string,gt_string>> TimedArray;
+  TimedFib f;
+  TimedArray a;
+  load(f,"fcijbdegah");
+  load(a,"fcijbdegah");
+  ASSERT_EQ("a",f.peek());
+  ASSERT_EQ("a",a.peek());
+  ASSERT_EQ("a",f.dequeue());
+  ASSERT_EQ("a",a.dequeue());
+
+  std::string fs, as;
+  for (const std::string& v : f)
+    fs += v;
+  for (const std::string& v : a)
+    as += v;
+  ASSERT_EQ("bcdefghij",fs);
+  ASSERT_EQ("bcdefghij",as);
+  TimedFib::Iterator fi = f.begin();
+  ASSERT_EQ("b",fi.erase());
+  ASSERT_EQ(8,f.size());
+
+  ASSERT_EQ(10,f.latency(TimedFib::ENQUEUE).count());
+  ASSERT_EQ(1,f.latency(TimedFib::DEQUEUE).count());
+  ASSERT_EQ(1,f.latency(TimedFib::PEEK).count());
+  ASSERT_EQ(2,f.latency(TimedFib::BEGIN).count());
+  ASSERT_EQ(9,f.latency(TimedFib::ITERATOR_PLUSPLUS).count());
+  ASSERT_EQ(1,f.latency(TimedFib::ITERATOR_ERASE).count());
+  ASSERT_EQ(10,a.latency(TimedArray::ENQUEUE).count());
+  ASSERT_EQ(1,a.latency(TimedArray::BEGIN).count());
+  f.clear();
+  ASSERT_EQ(1,f.latency(TimedFib::CLEAR).count());
+
+  std::ostringstream out;
+  f.print_latencies(out);
+  ASSERT_NE(std::string::npos,out.str().find("p99.9"));
+  ASSERT_NE(std::string::npos,out.str().find("iterator.erase"));
+  f.reset_latencies();
+  ASSERT_EQ(0,f.latency(TimedFib::ENQUEUE).count());
+}
+
+
 TEST_F(PriorityQueueTest, large_scale) {
   PriorityQueueTypeInt lq;
   ics::ArrayPriorityQueue<int,gt_int> lq_ref;